@@ -0,0 +1,18 @@
+#include "Allocator.h"
+
+namespace toolbox {
+
+namespace {
+HeapAllocator HEAP_ALLOCATOR {};
+IAllocator* DEFAULT_ALLOCATOR = &HEAP_ALLOCATOR;
+} // namespace
+
+IAllocator& defaultAllocator() {
+    return *DEFAULT_ALLOCATOR;
+}
+
+void setDefaultAllocator(IAllocator& allocator) {
+    DEFAULT_ALLOCATOR = &allocator;
+}
+
+} // namespace toolbox
@@ -0,0 +1,267 @@
+#ifndef TOOLBOX_ALLOCATOR_H_
+#define TOOLBOX_ALLOCATOR_H_
+
+#include <Arduino.h>
+#include <stddef.h>
+#include <stdlib.h>
+#ifdef TOOLBOX_ATOMIC_REFCOUNT
+#include <mutex>
+#endif
+
+namespace toolbox {
+
+/**
+ * Alignment of all blocks returned by the allocators.
+ */
+constexpr size_t ALLOCATION_ALIGNMENT = alignof(max_align_t);
+
+/**
+ * Statistics of an allocator.
+ */
+struct AllocatorStatistics final {
+  size_t liveBlocks = 0u;
+  size_t liveBytes = 0u;
+  size_t peakBytes = 0u;
+  size_t failedAllocations = 0u;
+
+  void allocated(size_t size) {
+    liveBlocks += 1u;
+    liveBytes += size;
+    if (liveBytes > peakBytes) {
+      peakBytes = liveBytes;
+    }
+  }
+
+  void deallocated(size_t size) {
+    liveBlocks -= 1u;
+    liveBytes -= size;
+  }
+
+  void failed() {
+    failedAllocations += 1u;
+  }
+};
+
+/**
+ * Minimal interface for memory allocators.
+ *
+ * Allocation failures are signaled by returning nullptr. The size passed to
+ * deallocate() must be the same as the one passed to allocate().
+ *
+ * Except for HeapAllocator, the implementations are not synchronized and must only
+ * be used by a single thread.
+ */
+class IAllocator {
+public:
+  virtual void* allocate(size_t size) = 0;
+  virtual void deallocate(void* block, size_t size) = 0;
+  virtual const AllocatorStatistics& statistics() const = 0;
+};
+
+/**
+ * Allocator using the global heap (i.e. malloc()/free(), which signal failures by
+ * returning nullptr instead of throwing like operator new).
+ *
+ * With TOOLBOX_ATOMIC_REFCOUNT, the updates of its statistics are synchronized, as
+ * strings shared between threads may be released by any of them.
+ */
+class HeapAllocator final : public IAllocator {
+  AllocatorStatistics _statistics;
+#ifdef TOOLBOX_ATOMIC_REFCOUNT
+  std::mutex _mutex;
+#endif
+
+public:
+  void* allocate(size_t size) override {
+    void* block = malloc(size);
+#ifdef TOOLBOX_ATOMIC_REFCOUNT
+    std::lock_guard<std::mutex> lock {_mutex};
+#endif
+    if (block != nullptr) {
+      _statistics.allocated(size);
+    } else {
+      _statistics.failed();
+    }
+    return block;
+  }
+
+  void deallocate(void* block, size_t size) override {
+    free(block);
+#ifdef TOOLBOX_ATOMIC_REFCOUNT
+    std::lock_guard<std::mutex> lock {_mutex};
+#endif
+    _statistics.deallocated(size);
+  }
+
+  const AllocatorStatistics& statistics() const override {
+    return _statistics;
+  }
+};
+
+/**
+ * Bump allocator on a caller-provided buffer.
+ *
+ * Deallocating blocks does not make their memory available again, this only happens
+ * when resetting the arena. It is meant for short-lived allocations, e.g. for the
+ * strings created while handling a single request.
+ */
+class ArenaAllocator final : public IAllocator {
+  char* _buffer;
+  size_t _size;
+  size_t _used;
+  AllocatorStatistics _statistics;
+
+public:
+  template<size_t N>
+  ArenaAllocator(char (&buffer)[N]) : ArenaAllocator(buffer, N) {}
+
+  ArenaAllocator(char* buffer, size_t size) : _buffer(buffer), _size(size), _used(0u), _statistics() {}
+
+  void* allocate(size_t size) override {
+    size_t misalignment = (reinterpret_cast<uintptr_t>(_buffer) + _used) % ALLOCATION_ALIGNMENT;
+    size_t start = misalignment == 0u ? _used : _used + ALLOCATION_ALIGNMENT - misalignment;
+    if (start > _size || size > _size - start) {
+      _statistics.failed();
+      return nullptr;
+    }
+    _used = start + size;
+    _statistics.allocated(size);
+    return _buffer + start;
+  }
+
+  void deallocate(void*, size_t size) override {
+    _statistics.deallocated(size);
+  }
+
+  const AllocatorStatistics& statistics() const override {
+    return _statistics;
+  }
+
+  size_t available() const {
+    return _size - _used;
+  }
+
+  /**
+   * Make the whole buffer available again.
+   *
+   * All blocks allocated before must not be used anymore (i.e. all strings
+   * using this arena must have been released before).
+   */
+  void reset() {
+    _used = 0u;
+  }
+};
+
+/**
+ * Allocator with pools of fixed-size blocks (16, 32, 64 and 128 bytes) on a
+ * caller-provided buffer.
+ *
+ * Blocks are taken from the buffer when needed and returned to a free list of their
+ * size class when deallocated, so they can be reused by allocations of similar size
+ * without fragmenting the buffer. Larger allocations fail.
+ */
+class PoolAllocator final : public IAllocator {
+public:
+  static constexpr size_t SIZE_CLASSES = 4u;
+  static constexpr size_t MIN_BLOCK_SIZE = 16u;
+  static constexpr size_t MAX_BLOCK_SIZE = MIN_BLOCK_SIZE << (SIZE_CLASSES - 1u);
+
+private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  char* _buffer;
+  size_t _size;
+  size_t _used;
+  FreeBlock* _freeLists[SIZE_CLASSES];
+  AllocatorStatistics _statistics;
+
+  static size_t sizeClass(size_t size) {
+    size_t sizeClass = 0u;
+    while ((MIN_BLOCK_SIZE << sizeClass) < size) {
+      sizeClass += 1u;
+    }
+    return sizeClass;
+  }
+
+public:
+  template<size_t N>
+  PoolAllocator(char (&buffer)[N]) : PoolAllocator(buffer, N) {}
+
+  PoolAllocator(char* buffer, size_t size) : _buffer(buffer), _size(size), _used(0u), _freeLists(), _statistics() {
+    size_t misalignment = reinterpret_cast<uintptr_t>(buffer) % ALLOCATION_ALIGNMENT;
+    if (misalignment != 0u) {
+      _used = ALLOCATION_ALIGNMENT - misalignment < _size ? ALLOCATION_ALIGNMENT - misalignment : _size;
+    }
+  }
+
+  void* allocate(size_t size) override {
+    if (size > MAX_BLOCK_SIZE) {
+      _statistics.failed();
+      return nullptr;
+    }
+
+    size_t i = sizeClass(size);
+    size_t blockSize = MIN_BLOCK_SIZE << i;
+    void* block = nullptr;
+    if (_freeLists[i] != nullptr) {
+      block = _freeLists[i];
+      _freeLists[i] = _freeLists[i]->next;
+    } else if (blockSize <= _size - _used) {
+      block = _buffer + _used;
+      _used += blockSize;
+    } else {
+      _statistics.failed();
+      return nullptr;
+    }
+
+    _statistics.allocated(blockSize);
+    return block;
+  }
+
+  void deallocate(void* block, size_t size) override {
+    size_t i = sizeClass(size);
+    FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+    freeBlock->next = _freeLists[i];
+    _freeLists[i] = freeBlock;
+    _statistics.deallocated(MIN_BLOCK_SIZE << i);
+  }
+
+  const AllocatorStatistics& statistics() const override {
+    return _statistics;
+  }
+};
+
+/**
+ * Get the allocator used by default (e.g. by shared_str), which initially
+ * is a HeapAllocator.
+ */
+IAllocator& defaultAllocator();
+
+/**
+ * Set the allocator used by default.
+ */
+void setDefaultAllocator(IAllocator& allocator);
+
+/**
+ * Scoped helper that sets the default allocator and restores the previous one
+ * when leaving the scope.
+ */
+class AllocatorScope final {
+  IAllocator& _previous;
+
+public:
+  AllocatorScope(IAllocator& allocator) : _previous(defaultAllocator()) {
+    setDefaultAllocator(allocator);
+  }
+  AllocatorScope(const AllocatorScope& other) = delete;
+  AllocatorScope& operator=(const AllocatorScope& other) = delete;
+  ~AllocatorScope() {
+    setDefaultAllocator(_previous);
+  }
+};
+
+}
+
+#endif
@@ -3,10 +3,569 @@
 
 #include "String.h"
 #include "Maybe.h"
+#include "Streams.h"
 #include <limits.h>
+#include <limits>
+#include <type_traits>
 
 namespace toolbox {
 
+namespace arithmetic {
+
+/**
+ * Unsigned 128 bit integer for intermediate results of 64 bit arithmetic.
+ */
+struct uint128 final {
+  uint64_t low;
+  uint64_t high;
+};
+
+/**
+ * Full 128 bit product of two 64 bit integers.
+ */
+inline uint128 multiply(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+  const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+  return {static_cast<uint64_t>(product), static_cast<uint64_t>(product >> 64)};
+#else
+  const uint64_t aLow = a & UINT32_MAX;
+  const uint64_t aHigh = a >> 32;
+  const uint64_t bLow = b & UINT32_MAX;
+  const uint64_t bHigh = b >> 32;
+  const uint64_t lowLow = aLow * bLow;
+  const uint64_t lowHigh = aLow * bHigh;
+  const uint64_t highLow = aHigh * bLow;
+  const uint64_t highHigh = aHigh * bHigh;
+  const uint64_t middle = (lowLow >> 32) + (lowHigh & UINT32_MAX) + (highLow & UINT32_MAX);
+  return {(middle << 32) | (lowLow & UINT32_MAX), highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32)};
+#endif
+}
+
+}
+
+namespace formatting {
+
+/**
+ * Maximum length of a formatted integer in base 10 (a 64 bit integer including the sign).
+ */
+constexpr size_t MAX_INTEGER_LENGTH = 20u;
+
+/**
+ * Decimal digit pairs "00" to "99", to produce two digits per division.
+ *
+ * The tables are indexed at run time, so they are placed in PROGMEM (and read with
+ * memcpy_P()) to keep them out of RAM on AVR.
+ */
+inline const char DIGIT_PAIRS[201] PROGMEM =
+    "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+    "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+inline const uint32_t POWERS_OF_TEN_32[10] PROGMEM = {
+    1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u
+};
+
+inline const uint64_t POWERS_OF_TEN_64[20] PROGMEM = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+    1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+    100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+    1000000000000000000ull, 10000000000000000000ull
+};
+
+/**
+ * 10^exponent for exponent < 10.
+ */
+inline uint32_t powerOfTen32(uint8_t exponent) {
+  uint32_t power;
+  memcpy_P(&power, POWERS_OF_TEN_32 + exponent, sizeof(power));
+  return power;
+}
+
+/**
+ * 10^exponent for exponent < 20.
+ */
+inline uint64_t powerOfTen64(uint8_t exponent) {
+  uint64_t power;
+  memcpy_P(&power, POWERS_OF_TEN_64 + exponent, sizeof(power));
+  return power;
+}
+
+/**
+ * Number of decimal digits of value (at least one).
+ *
+ * The number of bits approximates log10 (1233 / 4096 ~ log10(2)), which is corrected by
+ * a single comparison with a power of ten instead of a loop or a chain of branches.
+ */
+inline uint8_t countDigits(uint32_t value) {
+  value |= 1u;
+  // Not __builtin_clz(), which takes a 16 bit unsigned int on AVR
+  const uint32_t bits = 8u * sizeof(unsigned long) - __builtin_clzl(value);
+  const uint32_t log10 = (bits * 1233u) >> 12;
+  return log10 + 1u - (value < powerOfTen32(log10));
+}
+
+inline uint8_t countDigits(uint64_t value) {
+  value |= 1u;
+  const uint32_t log10 = ((64u - __builtin_clzll(value)) * 1233u) >> 12;
+  return log10 + 1u - (value < powerOfTen64(log10));
+}
+
+/**
+ * Write the decimal digits of value backwards, ending right before end.
+ */
+inline void writeDigits(uint32_t value, char* end) {
+  while (value >= 100u) {
+    const uint32_t pair = (value % 100u) * 2u;
+    value /= 100u;
+    end -= 2;
+    memcpy_P(end, DIGIT_PAIRS + pair, 2);
+  }
+  if (value >= 10u) {
+    memcpy_P(end - 2, DIGIT_PAIRS + value * 2u, 2);
+  } else {
+    end[-1] = static_cast<char>('0' + value);
+  }
+}
+
+/**
+ * Write exactly 8 decimal digits of value (including leading zeros), ending right before end.
+ */
+inline void writeEightDigits(uint32_t value, char* end) {
+  for (int i = 0; i < 4; ++i) {
+    const uint32_t pair = (value % 100u) * 2u;
+    value /= 100u;
+    end -= 2;
+    memcpy_P(end, DIGIT_PAIRS + pair, 2);
+  }
+}
+
+inline void writeDigits(uint64_t value, char* end) {
+  // Split off chunks of 8 digits, so at most two 64 bit divisions are needed (which are
+  // expensive on 32 bit MCUs) and the digits are produced with 32 bit divisions.
+  while (value > UINT32_MAX) {
+    const uint32_t chunk = static_cast<uint32_t>(value % 100000000u);
+    value /= 100000000u;
+    writeEightDigits(chunk, end);
+    end -= 8;
+  }
+  writeDigits(static_cast<uint32_t>(value), end);
+}
+
+/**
+ * Format an integer in base 10 into buffer, without a terminating zero.
+ *
+ * Returns the number of characters written, or 0 if the buffer is too small (in which
+ * case nothing is written).
+ */
+template<typename T>
+size_t formatInteger(T value, char* buffer, size_t size) {
+  using U = std::conditional_t<(sizeof(T) > sizeof(uint32_t)), uint64_t, uint32_t>;
+  const bool negative = value < 0;
+  const U magnitude = negative ? U(0) - U(value) : U(value);
+  const size_t digits = countDigits(magnitude);
+  const size_t length = digits + (negative ? 1u : 0u);
+  if (length > size) {
+    return 0;
+  }
+  if (negative) {
+    buffer[0] = '-';
+  }
+  writeDigits(magnitude, buffer + length);
+  return length;
+}
+
+/**
+ * Format an integer in any base from 2 to 36 into buffer, without a terminating zero.
+ *
+ * Returns the number of characters written, or 0 if the buffer is too small (or the base
+ * is not supported).
+ */
+template<typename T>
+size_t formatInteger(T value, char* buffer, size_t size, int base) {
+  if (base == 10) {
+    return formatInteger(value, buffer, size);
+  }
+  if (base < 2 || base > 36) {
+    return 0;
+  }
+
+  using U = std::make_unsigned_t<T>;
+  const bool negative = value < 0;
+  U magnitude = negative ? U(0) - U(value) : U(value);
+  char digits[8 * sizeof(T)];
+  char* start = digits + sizeof(digits);
+  do {
+    const uint8_t digit = magnitude % U(base);
+    magnitude /= U(base);
+    *--start = static_cast<char>(digit < 10u ? '0' + digit : 'a' + digit - 10u);
+  } while (magnitude > 0u);
+
+  const size_t digitCount = digits + sizeof(digits) - start;
+  const size_t length = digitCount + (negative ? 1u : 0u);
+  if (length > size) {
+    return 0;
+  }
+  if (negative) {
+    buffer[0] = '-';
+  }
+  memcpy(buffer + length - digitCount, start, digitCount);
+  return length;
+}
+
+/**
+ * Format an integer in base 10 to the given output.
+ */
+template<typename T>
+size_t formatInteger(T value, IOutput& output) {
+  char buffer[MAX_INTEGER_LENGTH];
+  return output.write(strref{buffer, formatInteger(value, buffer, sizeof(buffer))});
+}
+
+/**
+ * Maximum length of a formatted floating point number (see formatFloatingPoint()).
+ */
+constexpr size_t MAX_FLOATING_POINT_LENGTH = 25u;
+
+/**
+ * Format a floating point number with the fewest digits which parse back to the same
+ * number (Grisu2, which in rare cases produces one digit more than necessary), without
+ * a terminating zero.
+ *
+ * Numbers from 1e-6 to 1e21 are formatted in decimal notation ("0.001234", "12.34",
+ * "1234000"), others in exponential notation ("1.234e+30"). Special values are "nan",
+ * "inf" and "-inf".
+ *
+ * Returns the number of characters written, or 0 if the buffer is too small.
+ */
+size_t formatFloatingPoint(float value, char* buffer, size_t size);
+size_t formatFloatingPoint(double value, char* buffer, size_t size);
+
+/**
+ * Format a floating point number to the given output.
+ */
+template<typename T>
+size_t formatFloatingPoint(T value, IOutput& output) {
+  char buffer[MAX_FLOATING_POINT_LENGTH];
+  return output.write(strref{buffer, formatFloatingPoint(value, buffer, sizeof(buffer))});
+}
+
+}
+
+namespace parsing {
+
+inline bool isSpace(char c) {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/**
+ * Value of a digit in bases up to 36, or UINT8_MAX for other characters.
+ */
+inline uint8_t digitValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  c |= 0x20;
+  if (c >= 'a' && c <= 'z') {
+    return c - 'a' + 10;
+  }
+  return UINT8_MAX;
+}
+
+/**
+ * Check whether all 8 characters of a (little endian) word are decimal digits.
+ */
+inline bool isEightDigits(uint64_t word) {
+  return ((word & 0xF0F0F0F0F0F0F0F0ull) | (((word + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+}
+
+/**
+ * Convert 8 decimal digits in a (little endian) word at once, combining adjacent digits,
+ * then pairs, then quadruples of digits in all lanes in parallel.
+ */
+inline uint32_t parseEightDigits(uint64_t word) {
+  word -= 0x3030303030303030ull;
+  word = (word * 10u + (word >> 8)) & 0x00FF00FF00FF00FFull;
+  word = (word * 100u + (word >> 16)) & 0x0000FFFF0000FFFFull;
+  return static_cast<uint32_t>(word * 10000u + (word >> 32));
+}
+
+/**
+ * Parse an integer with the syntax of strtol() (leading whitespace, optional sign, "0x"
+ * prefix for base 16 and base 0) directly from a typed view.
+ *
+ * In contrast to strtol(), any overflow of T is an error, as is a minus sign for a
+ * non-zero unsigned value. On success, position is set to the index after the last digit.
+ */
+template<typename T, typename Tag>
+Maybe<T> parseInteger(const basic_strref<Tag>& string, int base, size_t& position) {
+  using U = std::make_unsigned_t<T>;
+  const size_t length = string.length();
+
+  size_t i = 0;
+  while (i < length && isSpace(string.charAt(i))) {
+    ++i;
+  }
+  bool negative = false;
+  if (i < length && (string.charAt(i) == '-' || string.charAt(i) == '+')) {
+    negative = string.charAt(i) == '-';
+    ++i;
+  }
+  if ((base == 0 || base == 16) && i + 2 < length && string.charAt(i) == '0'
+      && (string.charAt(i + 1) | 0x20) == 'x' && digitValue(string.charAt(i + 2)) < 16) {
+    base = 16;
+    i += 2;
+  } else if (base == 0) {
+    base = i < length && string.charAt(i) == '0' ? 8 : 10;
+  }
+  if (base < 2 || base > 36) {
+    return {};
+  }
+
+  constexpr U MAX_POSITIVE = U(std::numeric_limits<T>::max());
+  constexpr U MAX_NEGATIVE = std::is_signed<T>::value ? U(MAX_POSITIVE + 1u) : U(0);
+  const U limit = negative ? MAX_NEGATIVE : MAX_POSITIVE;
+  // Constants for base 10, to avoid (slow) divisions of 64 bit integers on 32 bit MCUs
+  const U cutoff = base == 10 ? (negative ? MAX_NEGATIVE / 10u : MAX_POSITIVE / 10u) : limit / U(base);
+  const uint8_t cutoffDigit = base == 10 ? (negative ? MAX_NEGATIVE % 10u : MAX_POSITIVE % 10u) : limit % U(base);
+
+  const size_t start = i;
+  U value = 0;
+  if (sizeof(U) >= sizeof(uint32_t) && base == 10) {
+    // Parse 8 digits at once while the result cannot overflow
+    constexpr uint32_t EIGHT_DIGITS = 100000000u;
+    constexpr U SWAR_MAX_POSITIVE = MAX_POSITIVE >= EIGHT_DIGITS ? U((MAX_POSITIVE - (EIGHT_DIGITS - 1u)) / EIGHT_DIGITS) : U(0);
+    constexpr U SWAR_MAX_NEGATIVE = MAX_NEGATIVE >= EIGHT_DIGITS ? U((MAX_NEGATIVE - (EIGHT_DIGITS - 1u)) / EIGHT_DIGITS) : U(0);
+    const U swarLimit = negative ? SWAR_MAX_NEGATIVE : SWAR_MAX_POSITIVE;
+    char buffer[sizeof(uint64_t)];
+    while (limit >= EIGHT_DIGITS && value <= swarLimit && length - i >= sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, Tag::block(string.data() + i, sizeof(word), buffer), sizeof(word));
+      if (!isEightDigits(word)) {
+        break;
+      }
+      value = value * U(EIGHT_DIGITS) + parseEightDigits(word);
+      i += sizeof(uint64_t);
+    }
+  }
+  if (base == 10 && i == start && (std::is_signed<T>::value || !negative)) {
+    // The first digits10 digits cannot overflow, so they need neither digitValue() nor checks
+    const size_t safeEnd = i + min(length - i, size_t(std::numeric_limits<T>::digits10));
+    for (; i < safeEnd; ++i) {
+      const uint8_t digit = uint8_t(string.charAt(i) - '0');
+      if (digit > 9) {
+        break;
+      }
+      value = value * 10u + digit;
+    }
+  }
+  for (; i < length; ++i) {
+    const uint8_t digit = digitValue(string.charAt(i));
+    if (digit >= base) {
+      break;
+    }
+    if (value > cutoff || (value == cutoff && digit > cutoffDigit)) {
+      return {};
+    }
+    value = value * U(base) + digit;
+  }
+  if (i == start) {
+    return {};
+  }
+
+  position = i;
+  return static_cast<T>(negative ? U(U(0) - value) : value);
+}
+
+/**
+ * Parse an integer from any strref without copying it, see parseInteger() for typed views.
+ *
+ * On success, end (if given) is set to the rest of the string after the last digit.
+ */
+template<typename T>
+Maybe<T> parseInteger(const strref& string, strref* end, int base) {
+  size_t position = 0;
+  Maybe<T> value = string.visit([base, &position] (auto view) { return parseInteger<T>(view, base, position); });
+  if (value.available() && end != nullptr) {
+    *end = string.skip(position);
+  }
+  return value;
+}
+
+/**
+ * Compute the floating point number closest to (-)w * 10^q.
+ *
+ * Returns false in the (rare) cases where the fast algorithm cannot decide.
+ */
+bool computeFloatingPoint(uint64_t w, int32_t q, bool negative, float& value);
+bool computeFloatingPoint(uint64_t w, int32_t q, bool negative, double& value);
+
+/**
+ * Parse a normalized, zero-terminated number with strtod() as a fallback.
+ */
+void parseFloatingPointSlow(const char* normalized, float& value);
+void parseFloatingPointSlow(const char* normalized, double& value);
+
+/**
+ * Number of significant digits passed to the fallback. A number exactly halfway between
+ * two neighbouring values of T has at most 767 (binary64) or 112 (binary32) significant
+ * digits, so only whether any further digit is non-zero matters for the rounding.
+ */
+template<typename T>
+constexpr size_t MAX_SLOW_PATH_DIGITS = sizeof(T) == sizeof(uint64_t) ? 769u : 114u;
+
+/**
+ * Parse a floating point number with the syntax of strtod() (leading whitespace, optional
+ * sign, digits with an optional decimal point and exponent, or "inf", "infinity" and
+ * "nan" in any case; no hexadecimal numbers) directly from a typed view.
+ *
+ * Up to 19 significant digits are collected into an integer, which is converted
+ * exactly with Clinger's fast path or the Eisel-Lemire algorithm. Only if these cannot
+ * decide, the significant digits are copied into a (stack) buffer for strtod(), the
+ * ones beyond MAX_SLOW_PATH_DIGITS replaced by a single sticky digit.
+ */
+template<typename T, typename Tag>
+Maybe<T> parseFloatingPoint(const basic_strref<Tag>& string, size_t& position) {
+  constexpr int MAX_DIGITS = 19;
+  const size_t length = string.length();
+
+  size_t i = 0;
+  while (i < length && isSpace(string.charAt(i))) {
+    ++i;
+  }
+  bool negative = false;
+  if (i < length && (string.charAt(i) == '-' || string.charAt(i) == '+')) {
+    negative = string.charAt(i) == '-';
+    ++i;
+  }
+
+  const basic_strref<Tag> rest = string.skip(i);
+  const bool infinity = rest.leftmost(3).equalsIgnoreCase(basic_strref<RamTag>{"inf", 3});
+  if (infinity || rest.leftmost(3).equalsIgnoreCase(basic_strref<RamTag>{"nan", 3})) {
+    position = i + (infinity && rest.leftmost(8).equalsIgnoreCase(basic_strref<RamTag>{"infinity", 8}) ? 8 : 3);
+    const T value = infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::quiet_NaN();
+    return negative ? -value : value;
+  }
+
+  // Significant digits w (after leading zeros) and the decimal exponent q
+  const size_t start = i;
+  uint64_t w = 0;
+  int32_t q = 0;
+  int significantDigits = 0;
+  bool truncated = false;
+  bool anyDigit = false;
+  bool fraction = false;
+  for (; i < length; ++i) {
+    const char c = string.charAt(i);
+    if (c == '.' && !fraction) {
+      fraction = true;
+      continue;
+    }
+    const uint8_t digit = static_cast<uint8_t>(c - '0');
+    if (digit > 9u) {
+      break;
+    }
+    anyDigit = true;
+    if (significantDigits < MAX_DIGITS) {
+      if (w != 0u || digit != 0u) {
+        w = w * 10u + digit;
+        ++significantDigits;
+      }
+      q -= fraction ? 1 : 0;
+    } else {
+      truncated |= digit != 0u;
+      q += fraction ? 0 : 1;
+    }
+  }
+  if (!anyDigit) {
+    return {};
+  }
+
+  if (i < length && (string.charAt(i) | 0x20) == 'e') {
+    size_t j = i + 1;
+    bool negativeExponent = false;
+    if (j < length && (string.charAt(j) == '-' || string.charAt(j) == '+')) {
+      negativeExponent = string.charAt(j) == '-';
+      ++j;
+    }
+    if (j < length && static_cast<uint8_t>(string.charAt(j) - '0') <= 9u) {
+      int32_t exponent = 0;
+      for (; j < length && static_cast<uint8_t>(string.charAt(j) - '0') <= 9u; ++j) {
+        if (exponent < 100000) {
+          exponent = exponent * 10 + (string.charAt(j) - '0');
+        }
+      }
+      q += negativeExponent ? -exponent : exponent;
+      i = j;
+    }
+  }
+  position = i;
+
+  T value;
+  if (!truncated) {
+    if (computeFloatingPoint(w, q, negative, value)) {
+      return value;
+    }
+  } else {
+    // The result is certain if it is the same for the truncated and the next larger significand
+    T upper;
+    if (computeFloatingPoint(w, q, negative, value) && computeFloatingPoint(w + 1u, q, negative, upper) && value == upper) {
+      return value;
+    }
+  }
+
+  // Fallback: "-0.<significant digits>e<exponent>", truncating digits that cannot matter
+  char normalized[MAX_SLOW_PATH_DIGITS<T> + 20];
+  char* out = normalized;
+  if (negative) {
+    *out++ = '-';
+  }
+  *out++ = '0';
+  *out++ = '.';
+  size_t digits = 0;
+  bool sticky = false;
+  for (size_t j = start; j < i; ++j) {
+    const char c = string.charAt(j);
+    if (c == '.') {
+      continue;
+    }
+    if ((c | 0x20) == 'e') {
+      break;
+    }
+    if (digits == 0u && c == '0') {
+      continue;
+    }
+    if (digits < MAX_SLOW_PATH_DIGITS<T>) {
+      *out++ = c;
+      ++digits;
+    } else {
+      sticky |= c != '0';
+    }
+  }
+  if (sticky) {
+    *out++ = '1';
+  }
+  *out++ = 'e';
+  out += formatting::formatInteger(q + significantDigits, out, formatting::MAX_INTEGER_LENGTH);
+  *out = '\0';
+  parseFloatingPointSlow(normalized, value);
+  return value;
+}
+
+/**
+ * Parse a floating point number from any strref without copying it, see
+ * parseFloatingPoint() for typed views.
+ */
+template<typename T>
+Maybe<T> parseFloatingPoint(const strref& string, strref* end) {
+  size_t position = 0;
+  Maybe<T> value = string.visit([&position] (auto view) { return parseFloatingPoint<T>(view, position); });
+  if (value.available() && end != nullptr) {
+    *end = string.skip(position);
+  }
+  return value;
+}
+
+}
+
 /**
  * Generic conversion struct template.
  *
@@ -14,15 +573,19 @@ namespace toolbox {
  * Specializations for specific types provide methods to convert to/from strings.
  *
  * Note: The result provided by toString() can only be assumed to be valid until
- * the next call to toString() on any converter!
+ * the next call to toString() on any converter! Integer converters also provide
+ * toChars() and writeTo() to format into a buffer or output provided by the caller.
+ *
+ * The second parameter allows partial specializations for groups of types, e.g. for
+ * enums with names (see Enum.h).
  */
-template<typename T>
+template<typename T, typename = void>
 struct convert final {
   static strref toString(T value) { (void)value; return ""; }
   static Maybe<T> fromString(const strref& string) { (void)string; return {}; }
 };
 
-inline char NUMBER_STRING_BUFFER[2 + 8 * sizeof(long)];
+inline char NUMBER_STRING_BUFFER[2 + 8 * sizeof(long long)];
 
 template<>
 struct convert<char> final {
@@ -45,148 +608,249 @@ struct convert<char> final {
 
 template<>
 struct convert<unsigned char> final {
-  static strref toString(unsigned char value, int base) {
-    utoa(value, NUMBER_STRING_BUFFER, base);
+  static strref toString(unsigned char value, int base = 10) {
+    if (base == 10) {
+      NUMBER_STRING_BUFFER[formatting::formatInteger(value, NUMBER_STRING_BUFFER, sizeof(NUMBER_STRING_BUFFER) - 1)] = '\0';
+    } else {
+      utoa(value, NUMBER_STRING_BUFFER, base);
+    }
     return NUMBER_STRING_BUFFER;
   }
 
+  static size_t toChars(unsigned char value, char* buffer, size_t size) {
+    return formatting::formatInteger(value, buffer, size);
+  }
+
+  static size_t writeTo(unsigned char value, IOutput& output) {
+    return formatting::formatInteger(value, output);
+  }
+
   static Maybe<unsigned char> fromString(const strref& string, strref* end = nullptr, int base = 0) {
-    strref str = string.ensure_cstr();
-    char* endptr;
-    auto value = strtoul(str.cstr(), &endptr, base);
-    if (endptr == str.cstr() || value > UCHAR_MAX) {
-      return {};
-    }
-    if (end != nullptr) {
-      *end = str.skipTo(endptr);
-    }
-    return static_cast<unsigned char>(value);
+    return parsing::parseInteger<unsigned char>(string, end, base);
   }
 };
 
 template<>
 struct convert<short> final {
-  static strref toString(short value, int base) {
-    itoa(value, NUMBER_STRING_BUFFER, base);
+  static strref toString(short value, int base = 10) {
+    if (base == 10) {
+      NUMBER_STRING_BUFFER[formatting::formatInteger(value, NUMBER_STRING_BUFFER, sizeof(NUMBER_STRING_BUFFER) - 1)] = '\0';
+    } else {
+      itoa(value, NUMBER_STRING_BUFFER, base);
+    }
     return NUMBER_STRING_BUFFER;
   }
 
+  static size_t toChars(short value, char* buffer, size_t size) {
+    return formatting::formatInteger(value, buffer, size);
+  }
+
+  static size_t writeTo(short value, IOutput& output) {
+    return formatting::formatInteger(value, output);
+  }
+
   static Maybe<short> fromString(const strref& string, strref* end = nullptr, int base = 0) {
-    strref str = string.ensure_cstr();
-    char* endptr;
-    auto value = strtol(str.cstr(), &endptr, base);
-    if (endptr == str.cstr() || value < SHRT_MIN || value > SHRT_MAX) {
-      return {};
-    }
-    if (end != nullptr) {
-      *end = str.skipTo(endptr);
-    }
-    return static_cast<short>(value);
+    return parsing::parseInteger<short>(string, end, base);
   }
 };
 
 template<>
 struct convert<unsigned short> final {
-  static strref toString(unsigned short value, int base) {
-    utoa(value, NUMBER_STRING_BUFFER, base);
+  static strref toString(unsigned short value, int base = 10) {
+    if (base == 10) {
+      NUMBER_STRING_BUFFER[formatting::formatInteger(value, NUMBER_STRING_BUFFER, sizeof(NUMBER_STRING_BUFFER) - 1)] = '\0';
+    } else {
+      utoa(value, NUMBER_STRING_BUFFER, base);
+    }
     return NUMBER_STRING_BUFFER;
   }
 
+  static size_t toChars(unsigned short value, char* buffer, size_t size) {
+    return formatting::formatInteger(value, buffer, size);
+  }
+
+  static size_t writeTo(unsigned short value, IOutput& output) {
+    return formatting::formatInteger(value, output);
+  }
+
   static Maybe<unsigned short> fromString(const strref& string, strref* end = nullptr, int base = 0) {
-    strref str = string.ensure_cstr();
-    char* endptr;
-    auto value = strtoul(str.cstr(), &endptr, base);
-    if (endptr == str.cstr() || value > USHRT_MAX) {
-      return {};
-    }
-    if (end != nullptr) {
-      *end = str.skipTo(endptr);
-    }
-    return static_cast<unsigned short>(value);
+    return parsing::parseInteger<unsigned short>(string, end, base);
   }
 };
 
 template<>
 struct convert<int> final {
-  static strref toString(int value, int base) {
-    itoa(value, NUMBER_STRING_BUFFER, base);
+  static strref toString(int value, int base = 10) {
+    if (base == 10) {
+      NUMBER_STRING_BUFFER[formatting::formatInteger(value, NUMBER_STRING_BUFFER, sizeof(NUMBER_STRING_BUFFER) - 1)] = '\0';
+    } else {
+      itoa(value, NUMBER_STRING_BUFFER, base);
+    }
     return NUMBER_STRING_BUFFER;
   }
 
+  static size_t toChars(int value, char* buffer, size_t size) {
+    return formatting::formatInteger(value, buffer, size);
+  }
+
+  static size_t writeTo(int value, IOutput& output) {
+    return formatting::formatInteger(value, output);
+  }
+
   static Maybe<int> fromString(const strref& string, strref* end = nullptr, int base = 0) {
-    strref str = string.ensure_cstr();
-    char* endptr;
-    auto value = strtol(str.cstr(), &endptr, base);
-    if (endptr == str.cstr() || value < INT_MIN || value > INT_MAX) {
-      return {};
-    }
-    if (end != nullptr) {
-      *end = str.skipTo(endptr);
-    }
-    return static_cast<int>(value);
+    return parsing::parseInteger<int>(string, end, base);
   }
 };
 
 template<>
 struct convert<unsigned int> final {
-  static strref toString(unsigned int value, int base) {
-    utoa(value, NUMBER_STRING_BUFFER, base);
+  static strref toString(unsigned int value, int base = 10) {
+    if (base == 10) {
+      NUMBER_STRING_BUFFER[formatting::formatInteger(value, NUMBER_STRING_BUFFER, sizeof(NUMBER_STRING_BUFFER) - 1)] = '\0';
+    } else {
+      utoa(value, NUMBER_STRING_BUFFER, base);
+    }
     return NUMBER_STRING_BUFFER;
   }
 
+  static size_t toChars(unsigned int value, char* buffer, size_t size) {
+    return formatting::formatInteger(value, buffer, size);
+  }
+
+  static size_t writeTo(unsigned int value, IOutput& output) {
+    return formatting::formatInteger(value, output);
+  }
+
   static Maybe<unsigned int> fromString(const strref& string, strref* end = nullptr, int base = 0) {
-    strref str = string.ensure_cstr();
-    char* endptr;
-    auto value = strtoul(str.cstr(), &endptr, base);
-    if (endptr == str.cstr() || value > UINT_MAX) {
-      return {};
-    }
-    if (end != nullptr) {
-      *end = str.skipTo(endptr);
-    }
-    return static_cast<unsigned int>(value);
+    return parsing::parseInteger<unsigned int>(string, end, base);
   }
 };
 
 template<>
 struct convert<long> final {
-  static strref toString(long value, int base) {
-    ltoa(value, NUMBER_STRING_BUFFER, base);
+  static strref toString(long value, int base = 10) {
+    if (base == 10) {
+      NUMBER_STRING_BUFFER[formatting::formatInteger(value, NUMBER_STRING_BUFFER, sizeof(NUMBER_STRING_BUFFER) - 1)] = '\0';
+    } else {
+      ltoa(value, NUMBER_STRING_BUFFER, base);
+    }
     return NUMBER_STRING_BUFFER;
   }
 
+  static size_t toChars(long value, char* buffer, size_t size) {
+    return formatting::formatInteger(value, buffer, size);
+  }
+
+  static size_t writeTo(long value, IOutput& output) {
+    return formatting::formatInteger(value, output);
+  }
+
   static Maybe<long> fromString(const strref& string, strref* end = nullptr, int base = 0) {
-    strref str = string.ensure_cstr();
-    char* endptr;
-    auto value = strtol(str.cstr(), &endptr, base);
-    if (endptr == str.cstr()) {
-      return {};
-    }
-    if (end != nullptr) {
-      *end = str.skipTo(endptr);
-    }
-    return static_cast<long>(value);
+    return parsing::parseInteger<long>(string, end, base);
   }
 };
 
 template<>
 struct convert<unsigned long> final {
-  static strref toString(unsigned long value, int base) {
-    ultoa(value, NUMBER_STRING_BUFFER, base);
+  static strref toString(unsigned long value, int base = 10) {
+    if (base == 10) {
+      NUMBER_STRING_BUFFER[formatting::formatInteger(value, NUMBER_STRING_BUFFER, sizeof(NUMBER_STRING_BUFFER) - 1)] = '\0';
+    } else {
+      ultoa(value, NUMBER_STRING_BUFFER, base);
+    }
     return NUMBER_STRING_BUFFER;
   }
 
+  static size_t toChars(unsigned long value, char* buffer, size_t size) {
+    return formatting::formatInteger(value, buffer, size);
+  }
+
+  static size_t writeTo(unsigned long value, IOutput& output) {
+    return formatting::formatInteger(value, output);
+  }
+
   static Maybe<unsigned long> fromString(const strref& string, strref* end = nullptr, int base = 0) {
-    strref str = string.ensure_cstr();
-    char* endptr;
-    auto value = strtoul(str.cstr(), &endptr, base);
-    if (endptr == str.cstr()) {
-      return {};
-    }
-    if (end != nullptr) {
-      *end = str.skipTo(endptr);
-    }
-    return static_cast<unsigned long>(value);
+    return parsing::parseInteger<unsigned long>(string, end, base);
+  }
+};
+
+template<>
+struct convert<long long> final {
+  static strref toString(long long value, int base = 10) {
+    NUMBER_STRING_BUFFER[formatting::formatInteger(value, NUMBER_STRING_BUFFER, sizeof(NUMBER_STRING_BUFFER) - 1, base)] = '\0';
+    return NUMBER_STRING_BUFFER;
+  }
+
+  static size_t toChars(long long value, char* buffer, size_t size) {
+    return formatting::formatInteger(value, buffer, size);
+  }
+
+  static size_t writeTo(long long value, IOutput& output) {
+    return formatting::formatInteger(value, output);
+  }
+
+  static Maybe<long long> fromString(const strref& string, strref* end = nullptr, int base = 0) {
+    return parsing::parseInteger<long long>(string, end, base);
+  }
+};
+
+template<>
+struct convert<unsigned long long> final {
+  static strref toString(unsigned long long value, int base = 10) {
+    NUMBER_STRING_BUFFER[formatting::formatInteger(value, NUMBER_STRING_BUFFER, sizeof(NUMBER_STRING_BUFFER) - 1, base)] = '\0';
+    return NUMBER_STRING_BUFFER;
+  }
+
+  static size_t toChars(unsigned long long value, char* buffer, size_t size) {
+    return formatting::formatInteger(value, buffer, size);
+  }
+
+  static size_t writeTo(unsigned long long value, IOutput& output) {
+    return formatting::formatInteger(value, output);
+  }
+
+  static Maybe<unsigned long long> fromString(const strref& string, strref* end = nullptr, int base = 0) {
+    return parsing::parseInteger<unsigned long long>(string, end, base);
+  }
+};
+
+template<>
+struct convert<float> final {
+  static strref toString(float value) {
+    NUMBER_STRING_BUFFER[formatting::formatFloatingPoint(value, NUMBER_STRING_BUFFER, sizeof(NUMBER_STRING_BUFFER) - 1)] = '\0';
+    return NUMBER_STRING_BUFFER;
+  }
+
+  static size_t toChars(float value, char* buffer, size_t size) {
+    return formatting::formatFloatingPoint(value, buffer, size);
+  }
+
+  static size_t writeTo(float value, IOutput& output) {
+    return formatting::formatFloatingPoint(value, output);
+  }
+
+  static Maybe<float> fromString(const strref& string, strref* end = nullptr) {
+    return parsing::parseFloatingPoint<float>(string, end);
+  }
+};
+
+template<>
+struct convert<double> final {
+  static strref toString(double value) {
+    NUMBER_STRING_BUFFER[formatting::formatFloatingPoint(value, NUMBER_STRING_BUFFER, sizeof(NUMBER_STRING_BUFFER) - 1)] = '\0';
+    return NUMBER_STRING_BUFFER;
+  }
+
+  static size_t toChars(double value, char* buffer, size_t size) {
+    return formatting::formatFloatingPoint(value, buffer, size);
+  }
+
+  static size_t writeTo(double value, IOutput& output) {
+    return formatting::formatFloatingPoint(value, output);
+  }
+
+  static Maybe<double> fromString(const strref& string, strref* end = nullptr) {
+    return parsing::parseFloatingPoint<double>(string, end);
   }
 };
 
@@ -211,7 +875,7 @@ struct convert<bool> final {
   }
 
   static Maybe<bool> fromString(const strref& string, strref* end = nullptr, BoolFormat format = BoolFormat::Logic) {
-    strref str = string.ltrim(' ').ensure_cstr();
+    strref str = string.ltrim(' ');
     switch (format) {
       default:
       case BoolFormat::Logic:
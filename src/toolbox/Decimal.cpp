@@ -1,80 +1,260 @@
 #include "Decimal.h"
 
 #ifndef ARDUINO_AVR_NANO
-#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #endif
 
 namespace toolbox {
 
-uint8_t numberOfDigits(int32_t x) {
-  // Note: the implementation uses binary search to make the lookup take similar time for all orders of magnitude.
-  x = abs(x);
-  if (x < 100000) {
-    if (x < 1000) {
-      if (x < 10) {
-        return 1;
-      } else if (x < 100) {
-        return 2;
-      } else {
-        return 3;
-      }
-    } else {
-      if (x < 10000) {
-        return 4;
-      } else {
-        return 5;
-      }
-    }
-  } else {
-    if (x < 10000000) {
-      if (x < 1000000) {
-        return 6;
-      } else {
-        return 7;
-      }
-    } else {
-      if (x < 100000000) {
-        return 8;
-      } else if (x < 1000000000) {
-        return 9;
-      } else {
-        return 10;
-      }
-    }
+namespace {
+
+using arithmetic::uint128;
+
+inline uint64_t magnitudeOf(int64_t number) {
+  return number < 0 ? uint64_t(0) - uint64_t(number) : uint64_t(number);
+}
+
+inline bool lessThan(const uint128& a, const uint128& b) {
+  return a.high < b.high || (a.high == b.high && a.low < b.low);
+}
+
+inline uint128 subtract(const uint128& a, const uint128& b) {
+  return {a.low - b.low, a.high - b.high - (a.low < b.low ? 1u : 0u)};
+}
+
+/**
+ * Product of two 128 bit integers, or false on overflow.
+ */
+bool multiply(const uint128& a, const uint128& b, uint128& product) {
+  if (a.high != 0u && b.high != 0u) {
+    return false;
+  }
+  const uint128 low = arithmetic::multiply(a.low, b.low);
+  const uint128 cross = a.high != 0u ? arithmetic::multiply(a.high, b.low) : arithmetic::multiply(a.low, b.high);
+  product = {low.low, low.high + cross.low};
+  return cross.high == 0u && product.high >= low.high;
+}
+
+/**
+ * 10^exponent for exponents up to 38.
+ */
+uint128 powerOfTen128(uint8_t exponent) {
+  if (exponent < 20u) {
+    return {formatting::powerOfTen64(exponent), 0u};
   }
+  return arithmetic::multiply(formatting::powerOfTen64(19), formatting::powerOfTen64(min(exponent - 19u, 19u)));
 }
 
-int64_t powerOfTen(uint8_t exp) {
-  switch (exp) {
-    case 0: return 1;
-    case 1: return 10;
-    case 2: return 100;
-    case 3: return 1000;
-    case 4: return 10000;
-    case 5: return 100000;
-    case 6: return 1000000;
-    case 7: return 10000000;
-    case 8: return 100000000;
-    case 9: return 1000000000;
-    case 10: return 10000000000;
-    case 11: return 100000000000;
-    case 12: return 1000000000000;
-    case 13: return 10000000000000;
-    case 14: return 100000000000000;
-    case 15: return 1000000000000000;
-    case 16: return 10000000000000000;
-    case 17: return 100000000000000000;
-    case 18: return 1000000000000000000;
-    default: return 1;
+/**
+ * Quotient and remainder of 128 bit integers, with a 64 bit division if both fit.
+ */
+uint128 divide(const uint128& numerator, const uint128& divisor, uint128& remainder) {
+  if (numerator.high == 0u && divisor.high == 0u) {
+    remainder = {numerator.low % divisor.low, 0u};
+    return {numerator.low / divisor.low, 0u};
+  }
+#ifdef __SIZEOF_INT128__
+  const unsigned __int128 n = (static_cast<unsigned __int128>(numerator.high) << 64) | numerator.low;
+  const unsigned __int128 d = (static_cast<unsigned __int128>(divisor.high) << 64) | divisor.low;
+  const unsigned __int128 q = n / d;
+  const unsigned __int128 r = n - q * d;
+  remainder = {static_cast<uint64_t>(r), static_cast<uint64_t>(r >> 64)};
+  return {static_cast<uint64_t>(q), static_cast<uint64_t>(q >> 64)};
+#else
+  // Binary long division from the highest set bit of the numerator
+  uint128 quotient {0u, 0u};
+  remainder = {0u, 0u};
+  const int bits = numerator.high != 0u ? 128 - __builtin_clzll(numerator.high) : 64 - __builtin_clzll(numerator.low);
+  for (int i = bits - 1; i >= 0; --i) {
+    const uint64_t bit = i >= 64 ? (numerator.high >> (i - 64)) & 1u : (numerator.low >> i) & 1u;
+    remainder = {(remainder.low << 1) | bit, (remainder.high << 1) | (remainder.low >> 63)};
+    quotient = {quotient.low << 1, (quotient.high << 1) | (quotient.low >> 63)};
+    if (!lessThan(remainder, divisor)) {
+      remainder = subtract(remainder, divisor);
+      quotient.low |= 1u;
+    }
   }
+  return quotient;
+#endif
+}
+
 }
 
 int64_t rescale(int64_t number, int8_t exp) {
   return exp < 0 ? number / powerOfTen(-exp) : number * powerOfTen(exp);
 }
 
+size_t Decimal::toChars(char* buffer, size_t size) const {
+  if (_decimalPlaces == 0) {
+    return formatting::formatInteger(_number, buffer, size);
+  }
+  const bool negative = _number < 0;
+  const uint64_t magnitude = negative ? uint64_t(0) - uint64_t(_number) : uint64_t(_number);
+
+  // Split into the integer part and the decimal places with a single 64 bit division.
+  const bool hasIntegerPart = _decimalPlaces < 20u;
+  const uint64_t integerPart = hasIntegerPart ? magnitude / formatting::powerOfTen64(_decimalPlaces) : 0u;
+  const uint64_t fraction = hasIntegerPart ? magnitude - integerPart * formatting::powerOfTen64(_decimalPlaces) : magnitude;
+  const size_t integerDigits = formatting::countDigits(integerPart);
+  const size_t fractionDigits = formatting::countDigits(fraction);
+  const size_t length = (negative ? 1u : 0u) + integerDigits + 1u + _decimalPlaces;
+  if (length > size) {
+    return 0;
+  }
+
+  char* position = buffer;
+  if (negative) {
+    *position++ = '-';
+  }
+  position += integerDigits;
+  formatting::writeDigits(integerPart, position);
+  *position++ = '.';
+  memset(position, '0', _decimalPlaces - fractionDigits);
+  formatting::writeDigits(fraction, buffer + length);
+  return length;
+}
+
+Maybe<Decimal> Decimal::fromDigits(uint64_t significand, int32_t exponent, bool negative, bool truncated, uint8_t nextDigit, uint8_t decimalPlaces) {
+  if (decimalPlaces == AS_WRITTEN) {
+    if (truncated || exponent < -int32_t(MAX_DECIMAL_PLACES)) {
+      return {};
+    }
+    decimalPlaces = exponent < 0 ? uint8_t(-exponent) : 0u;
+  } else if (decimalPlaces > MAX_DECIMAL_PLACES) {
+    return {};
+  }
+
+  // Scale to the decimal places: multiply exactly, or divide once and round half up
+  const int32_t shift = exponent + decimalPlaces;
+  uint64_t magnitude = 0;
+  if (significand == 0u) {
+    magnitude = 0;
+  } else if (shift >= 0) {
+    // A truncated significand has 19 digits, so it only fits if it is not shifted
+    if (shift > 18 || __builtin_mul_overflow(significand, formatting::powerOfTen64(shift), &magnitude)) {
+      return {};
+    }
+    magnitude += truncated && nextDigit >= 5u ? 1u : 0u;
+  } else if (shift >= -19) {
+    const uint64_t divisor = formatting::powerOfTen64(-shift);
+    magnitude = significand / divisor;
+    magnitude += significand - magnitude * divisor >= divisor / 2u ? 1u : 0u;
+  }
+
+  const uint64_t limit = negative ? uint64_t(INT64_MAX) + 1u : uint64_t(INT64_MAX);
+  if (magnitude > limit) {
+    return {};
+  }
+  return Decimal{negative ? int64_t(uint64_t(0) - magnitude) : int64_t(magnitude), decimalPlaces};
+}
+
+Maybe<Decimal> Decimal::fromQuotient(uint128 numerator, uint128 divisor, bool negative, uint8_t decimalPlaces, Rounding rounding) {
+  uint128 remainder;
+  const uint128 quotient = toolbox::divide(numerator, divisor, remainder);
+  if (quotient.high != 0u) {
+    return {};
+  }
+  uint64_t magnitude = quotient.low;
+  if (rounding != Rounding::Truncate && (remainder.high != 0u || remainder.low != 0u)) {
+    // Compare the remainder with the other part of the divisor instead of doubling it
+    const uint128 rest = subtract(divisor, remainder);
+    const bool tie = rest.high == remainder.high && rest.low == remainder.low;
+    if (lessThan(rest, remainder) || (tie && (rounding == Rounding::HalfUp || (magnitude & 1u) != 0u))) {
+      ++magnitude;
+    }
+  }
+
+  const uint64_t limit = negative ? uint64_t(INT64_MAX) + 1u : uint64_t(INT64_MAX);
+  if (magnitude > limit) {
+    return {};
+  }
+  return Decimal{negative ? int64_t(uint64_t(0) - magnitude) : int64_t(magnitude), decimalPlaces};
+}
+
+Maybe<Decimal> Decimal::rescale(uint8_t decimalPlaces, Rounding rounding) const {
+  if (_decimalPlaces > MAX_DECIMAL_PLACES || decimalPlaces > MAX_DECIMAL_PLACES) {
+    return {};
+  }
+  if (decimalPlaces >= _decimalPlaces) {
+    int64_t number;
+    if (__builtin_mul_overflow(_number, powerOfTen(decimalPlaces - _decimalPlaces), &number)) {
+      return {};
+    }
+    return Decimal{number, decimalPlaces};
+  }
+  return fromQuotient({magnitudeOf(_number), 0u}, powerOfTen128(_decimalPlaces - decimalPlaces), _number < 0, decimalPlaces, rounding);
+}
+
+Maybe<Decimal> Decimal::addScaled(const Decimal& other, bool subtract) const {
+  int64_t a = _number;
+  int64_t b = other._number;
+  const uint8_t decimalPlaces = max(_decimalPlaces, other._decimalPlaces);
+  if (decimalPlaces > MAX_DECIMAL_PLACES
+      || __builtin_mul_overflow(a, powerOfTen(decimalPlaces - _decimalPlaces), &a)
+      || __builtin_mul_overflow(b, powerOfTen(decimalPlaces - other._decimalPlaces), &b)
+      || (subtract ? __builtin_sub_overflow(a, b, &a) : __builtin_add_overflow(a, b, &a))) {
+    return {};
+  }
+  return Decimal{a, decimalPlaces};
+}
+
+Maybe<Decimal> Decimal::multiply(const Decimal& other, uint8_t decimalPlaces, Rounding rounding) const {
+  if (_decimalPlaces > MAX_DECIMAL_PLACES || other._decimalPlaces > MAX_DECIMAL_PLACES || decimalPlaces > MAX_DECIMAL_PLACES) {
+    return {};
+  }
+  // The exact product has the decimal places of both operands
+  uint128 product = arithmetic::multiply(magnitudeOf(_number), magnitudeOf(other._number));
+  const bool negative = (_number < 0) != (other._number < 0);
+  const uint8_t productPlaces = _decimalPlaces + other._decimalPlaces;
+  if (decimalPlaces >= productPlaces) {
+    if (!toolbox::multiply(product, powerOfTen128(decimalPlaces - productPlaces), product)) {
+      return {};
+    }
+    return fromQuotient(product, {1u, 0u}, negative, decimalPlaces, rounding);
+  }
+  return fromQuotient(product, powerOfTen128(productPlaces - decimalPlaces), negative, decimalPlaces, rounding);
+}
+
+Maybe<Decimal> Decimal::divide(const Decimal& other, uint8_t decimalPlaces, Rounding rounding) const {
+  if (other._number == 0 || _decimalPlaces > MAX_DECIMAL_PLACES || other._decimalPlaces > MAX_DECIMAL_PLACES || decimalPlaces > MAX_DECIMAL_PLACES) {
+    return {};
+  }
+  // a / 10^p / (b / 10^q) * 10^r = a * 10^(r + q - p) / b
+  uint128 numerator {magnitudeOf(_number), 0u};
+  uint128 divisor {magnitudeOf(other._number), 0u};
+  const bool negative = (_number < 0) != (other._number < 0);
+  const int exponent = int(decimalPlaces) + other._decimalPlaces - _decimalPlaces;
+  if (exponent >= 0) {
+    if (!toolbox::multiply(numerator, powerOfTen128(uint8_t(exponent)), numerator)) {
+      return {};
+    }
+  } else {
+    divisor = arithmetic::multiply(divisor.low, formatting::powerOfTen64(-exponent));
+  }
+  return fromQuotient(numerator, divisor, negative, decimalPlaces, rounding);
+}
+
+int Decimal::compareScaled(const Decimal& a, const Decimal& b) {
+  if ((a._number < 0) != (b._number < 0)) {
+    return a._number < 0 ? -1 : 1;
+  }
+  // Compare the magnitudes with the same decimal places, which fit into 128 bits for a
+  // difference of up to 19 decimal places (and beyond, the other number has to be 0).
+  const bool aScaled = a._decimalPlaces < b._decimalPlaces;
+  const uint8_t difference = aScaled ? b._decimalPlaces - a._decimalPlaces : a._decimalPlaces - b._decimalPlaces;
+  uint128 magnitudeA {magnitudeOf(a._number), 0u};
+  uint128 magnitudeB {magnitudeOf(b._number), 0u};
+  uint128& scaled = aScaled ? magnitudeA : magnitudeB;
+  if (difference > 19u) {
+    scaled.high = scaled.low != 0u ? 1u : 0u;
+  } else {
+    scaled = arithmetic::multiply(scaled.low, formatting::powerOfTen64(difference));
+  }
+  const int order = lessThan(magnitudeA, magnitudeB) ? -1 : (lessThan(magnitudeB, magnitudeA) ? 1 : 0);
+  return a._number < 0 ? -order : order;
+}
+
 char Decimal::BUFFER[Decimal::MAX_STRING_LENGTH + 1] {};
 
 } // namespace toolbox
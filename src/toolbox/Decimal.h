@@ -5,23 +5,30 @@
 #include <functional>
 #include <algorithm>
 using std::abs;
+using std::max;
 #else
 #include <Arduino.h>
 #endif
 #include "Maybe.h"
 #include "String.h"
+#include "Conversion.h"
 
 namespace toolbox {
 
 /**
  * Get the number of digits of an integer (in base 10).
  */
-uint8_t numberOfDigits(int32_t x);
+inline uint8_t numberOfDigits(int64_t x) {
+  return formatting::countDigits(x < 0 ? uint64_t(0) - uint64_t(x) : uint64_t(x));
+}
 
 /**
- * Compute $10^{exp}$ for small non-negative exponents.
+ * Compute $10^{exp}$ for exponents up to 18 (which fit into int64_t), or 1 for larger
+ * exponents.
  */
-int64_t powerOfTen(uint8_t exp);
+inline int64_t powerOfTen(uint8_t exp) {
+  return exp <= 18u ? int64_t(formatting::powerOfTen64(exp)) : 1;
+}
 
 /**
  * Rescale a fixed-point value by adjusting the decimal exponent.
@@ -29,19 +36,53 @@ int64_t powerOfTen(uint8_t exp);
 int64_t rescale(int64_t number, int8_t exp);
 
 /**
- * Representation of decimal numbers for in- and output purposes.
+ * Rounding of results which have more decimal places than requested.
+ */
+enum struct Rounding : uint8_t {
+  /** To the nearest number, ties to the one with an even last digit (banker's rounding). */
+  HalfEven,
+  /** To the nearest number, ties away from zero (commercial rounding). */
+  HalfUp,
+  /** Towards zero. */
+  Truncate
+};
+
+/**
+ * Representation of decimal numbers as a 64 bit integer and a number of decimal places.
  *
- * It mainly provides conversion to and from strings, but also can convert
- * the number to other numeric primitive types, but that may loose precision
- * or may not be representable at all.
+ * It provides conversion to and from strings, conversion to other numeric primitive
+ * types (which may loose precision or may not be representable at all), and exact
+ * fixed-point arithmetic on the integers. Arithmetic results are empty on overflow of
+ * 64 bits, or for operands or results with more than MAX_DECIMAL_PLACES (except sums
+ * and differences of numbers with the same decimal places). Products and
+ * quotients are computed with 128 bit intermediates and rounded only once.
  *
- * It is limited in the range of numbers it can represent by the size of the
- * underlying integer type (64 bit), which also means that only a limited range
- * of decimal places can be safely used (up to 18).
+ * On MCUs without FPU, this avoids the software emulation of double. Additions,
+ * subtractions and comparisons of numbers with the same decimal places are a few integer
+ * instructions, which is expected to be an order of magnitude faster than emulated
+ * double operations. Multiplications and divisions need a division of up to 128 bits,
+ * which is in the same range as emulated double operations, but exact.
  */
 class Decimal final {
-  static constexpr auto MAX_DOT_POSITION = 21;
-  static constexpr auto MAX_STRING_LENGTH = 22;
+public:
+  /**
+   * Maximum length of a formatted number with up to 19 decimal places (sign, 19 digits
+   * or a leading zero and 19 decimal places, and the dot).
+   */
+  static constexpr size_t MAX_STRING_LENGTH = 22u;
+
+  /**
+   * Maximum number of decimal places of parsed numbers, as 10^18 is the largest power of
+   * ten in 64 bits.
+   */
+  static constexpr uint8_t MAX_DECIMAL_PLACES = 18u;
+
+  /**
+   * Parse numbers with the decimal places as written (see fromString()).
+   */
+  static constexpr uint8_t AS_WRITTEN = UINT8_MAX;
+
+private:
   static char BUFFER[MAX_STRING_LENGTH + 1];
 
   int64_t _number;
@@ -84,7 +125,7 @@ public:
     if (decimalPlaces == _decimalPlaces) {
       return _number;
     } else {
-      return rescale(_number, int8_t(decimalPlaces) - int8_t(_decimalPlaces));
+      return toolbox::rescale(_number, int8_t(decimalPlaces) - int8_t(_decimalPlaces));
     }
   }
 
@@ -92,6 +133,104 @@ public:
     return Decimal{fixedPoint, decimalPlaces};
   }
 
+  /**
+   * Round (or extend) the number to the given decimal places.
+   */
+  Maybe<Decimal> rescale(uint8_t decimalPlaces, Rounding rounding = Rounding::HalfEven) const;
+
+  /**
+   * Sum with the decimal places of the more precise operand.
+   */
+  Maybe<Decimal> operator+(const Decimal& other) const {
+    int64_t sum;
+    if (_decimalPlaces != other._decimalPlaces) {
+      return addScaled(other, false);
+    } else if (__builtin_add_overflow(_number, other._number, &sum)) {
+      return {};
+    }
+    return Decimal{sum, _decimalPlaces};
+  }
+
+  /**
+   * Difference with the decimal places of the more precise operand.
+   */
+  Maybe<Decimal> operator-(const Decimal& other) const {
+    int64_t difference;
+    if (_decimalPlaces != other._decimalPlaces) {
+      return addScaled(other, true);
+    } else if (__builtin_sub_overflow(_number, other._number, &difference)) {
+      return {};
+    }
+    return Decimal{difference, _decimalPlaces};
+  }
+
+  /**
+   * Product rounded to the decimal places of the more precise operand, e.g. a price per
+   * unit times a quantity, see multiply() for other decimal places.
+   */
+  Maybe<Decimal> operator*(const Decimal& other) const {
+    return multiply(other, max(_decimalPlaces, other._decimalPlaces));
+  }
+
+  /**
+   * Quotient rounded to the decimal places of the more precise operand, see divide() for
+   * other decimal places. Division by zero is an error.
+   */
+  Maybe<Decimal> operator/(const Decimal& other) const {
+    return divide(other, max(_decimalPlaces, other._decimalPlaces));
+  }
+
+  Maybe<Decimal> multiply(const Decimal& other, uint8_t decimalPlaces, Rounding rounding = Rounding::HalfEven) const;
+
+  Maybe<Decimal> divide(const Decimal& other, uint8_t decimalPlaces, Rounding rounding = Rounding::HalfEven) const;
+
+  /**
+   * Numeric comparison, independent of the decimal places (i.e. 1.5 equals 1.50).
+   */
+  bool operator==(const Decimal& other) const {
+    return compare(*this, other) == 0;
+  }
+
+  bool operator!=(const Decimal& other) const {
+    return compare(*this, other) != 0;
+  }
+
+  bool operator<(const Decimal& other) const {
+    return compare(*this, other) < 0;
+  }
+
+  bool operator<=(const Decimal& other) const {
+    return compare(*this, other) <= 0;
+  }
+
+  bool operator>(const Decimal& other) const {
+    return compare(*this, other) > 0;
+  }
+
+  bool operator>=(const Decimal& other) const {
+    return compare(*this, other) >= 0;
+  }
+
+  /**
+   * Format the number into buffer, without a terminating zero. Numbers with decimal
+   * places have at least one digit before the dot, e.g. "0.05".
+   *
+   * Returns the number of characters written, or 0 if the buffer is too small.
+   */
+  size_t toChars(char* buffer, size_t size) const;
+
+  /**
+   * Format the number to the given output (see toChars()).
+   *
+   * Returns the number of characters written, which is 0 for numbers with more than 19
+   * decimal places.
+   */
+  size_t writeTo(IOutput& output) const {
+    char buffer[MAX_STRING_LENGTH];
+    const size_t length = toChars(buffer, sizeof(buffer));
+    return length > 0u ? output.write(strref{buffer, length}) : 0u;
+  }
+
   /**
    * Converts the number into a string.
    *
@@ -103,58 +242,178 @@ public:
    */
   strref toString(char* buffer = nullptr) const {
     buffer = buffer ? buffer : BUFFER;
+    const size_t length = toChars(buffer, MAX_STRING_LENGTH);
+    buffer[length] = '\0';
+    return strref{buffer, length, true};
+  }
 
-    auto length = snprintf(buffer, MAX_STRING_LENGTH + 1, "%lli", _number);
-    if (_decimalPlaces > 0) {
-      auto signLength = _number < 0 ? 1 : 0;
-      length -= signLength;
-      if (_decimalPlaces >= length) {
-        memmove(buffer + signLength + _decimalPlaces - length + 1, buffer + signLength, length + 1);
-        memset(buffer + signLength, '0', _decimalPlaces - length + 1);
-        length += _decimalPlaces - length + 1;
-      }
-      // insert .
-      memmove(buffer + signLength + length - _decimalPlaces + 1, buffer + signLength + length - _decimalPlaces, _decimalPlaces + 1);
-      buffer[signLength + length - _decimalPlaces] = '.';
+  /**
+   * Parse a decimal number, with the syntax of strtod() for finite numbers (leading
+   * whitespace, optional sign, digits with an optional decimal point and exponent),
+   * directly from the given string without copying it.
+   *
+   * By default, the number keeps the decimal places as written, e.g. "1.50" has 2 and
+   * "15e-1" has 1 decimal place, which fails for more than MAX_DECIMAL_PLACES. Otherwise
+   * it is rounded (half away from zero) to the given number of decimal places. Numbers
+   * which do not fit into 64 bits (at that scale) are an error.
+   *
+   * If end is given, it is set to the rest of the string after the number, otherwise
+   * the whole string must be a number.
+   */
+  static Maybe<Decimal> fromString(const strref& string, strref* end = nullptr, uint8_t decimalPlaces = AS_WRITTEN) {
+    size_t position = 0;
+    Maybe<Decimal> value = string.visit([decimalPlaces, &position] (auto view) { return parse(view, decimalPlaces, position); });
+    if (!value.available()) {
+      return {};
     }
-
-    return buffer;
+    if (end != nullptr) {
+      *end = string.skip(position);
+    } else if (position != string.length()) {
+      return {};
+    }
+    return value;
   }
 
   /**
-   * Parses a decimal number from a string representation.
+   * Parse a decimal number from a typed view in a single pass, see fromString().
+   *
+   * Up to 19 significant digits are collected into an integer, further digits only
+   * decide the rounding. On success, position is set to the index after the number.
    */
-  static Maybe<Decimal> fromString(const strref& string) {
-    if (string.length() > MAX_STRING_LENGTH) {
-      return {};
+  template<typename Tag>
+  static Maybe<Decimal> parse(const basic_strref<Tag>& string, uint8_t decimalPlaces, size_t& position) {
+    constexpr int MAX_DIGITS = 19;
+    const size_t length = string.length();
+
+    size_t i = 0;
+    while (i < length && parsing::isSpace(string.charAt(i))) {
+      ++i;
+    }
+    bool negative = false;
+    if (i < length && (string.charAt(i) == '-' || string.charAt(i) == '+')) {
+      negative = string.charAt(i) == '-';
+      ++i;
     }
 
-    string.copy(BUFFER, MAX_STRING_LENGTH, true);
-    uint8_t decimalPlaces = 0;
+    // Significant digits (after leading zeros) and the decimal exponent
+    uint64_t significand = 0;
+    int32_t exponent = 0;
+    int significantDigits = 0;
+    bool truncated = false;
+    uint8_t nextDigit = 0;
+    bool anyDigit = false;
+    bool fraction = false;
+    for (; i < length; ++i) {
+      const char c = string.charAt(i);
+      if (c == '.' && !fraction) {
+        fraction = true;
+        continue;
+      }
+      const uint8_t digit = static_cast<uint8_t>(c - '0');
+      if (digit > 9u) {
+        break;
+      }
+      anyDigit = true;
+      if (significantDigits < MAX_DIGITS) {
+        if (significand != 0u || digit != 0u) {
+          significand = significand * 10u + digit;
+          ++significantDigits;
+        }
+        exponent -= fraction ? 1 : 0;
+      } else {
+        nextDigit = truncated ? nextDigit : digit;
+        truncated = true;
+        exponent += fraction ? 0 : 1;
+      }
+    }
+    if (!anyDigit) {
+      return {};
+    }
 
-    ssize_t dotPosition = string.indexOf('.');
-    if (dotPosition >= 0) {
-      if (dotPosition > MAX_DOT_POSITION) {
-        return {};
+    if (i < length && (string.charAt(i) | 0x20) == 'e') {
+      size_t j = i + 1;
+      bool negativeExponent = false;
+      if (j < length && (string.charAt(j) == '-' || string.charAt(j) == '+')) {
+        negativeExponent = string.charAt(j) == '-';
+        ++j;
+      }
+      if (j < length && static_cast<uint8_t>(string.charAt(j) - '0') <= 9u) {
+        int32_t value = 0;
+        for (; j < length && static_cast<uint8_t>(string.charAt(j) - '0') <= 9u; ++j) {
+          if (value < 100000) {
+            value = value * 10 + (string.charAt(j) - '0');
+          }
+        }
+        exponent += negativeExponent ? -value : value;
+        i = j;
       }
-      
-      decimalPlaces = string.skip(dotPosition + 1).copy(BUFFER + dotPosition, MAX_STRING_LENGTH - dotPosition, true);
     }
 
-    char* end = nullptr;
-    #ifdef ARDUINO_AVR_NANO
-    int64_t number = strtol(BUFFER, &end, 10);
-    #else
-    int64_t number = strtoll(BUFFER, &end, 10);
-    #endif
-    if (*end == '\0') {
-      return {Decimal{number, decimalPlaces}};
-    } else {
-      return {};
+    Maybe<Decimal> result = fromDigits(significand, exponent, negative, truncated, nextDigit, decimalPlaces);
+    if (result.available()) {
+      position = i;
+    }
+    return result;
+  }
+
+private:
+  static int compare(const Decimal& a, const Decimal& b) {
+    if (a._decimalPlaces == b._decimalPlaces) {
+      return a._number < b._number ? -1 : (a._number > b._number ? 1 : 0);
     }
+    return compareScaled(a, b);
   }
+
+  static int compareScaled(const Decimal& a, const Decimal& b);
+
+  /**
+   * Sum or difference of numbers with different decimal places.
+   */
+  Maybe<Decimal> addScaled(const Decimal& other, bool subtract) const;
+
+  /**
+   * Compute (-)numerator / divisor, rounded to an integer, with the given decimal places.
+   */
+  static Maybe<Decimal> fromQuotient(arithmetic::uint128 numerator, arithmetic::uint128 divisor, bool negative, uint8_t decimalPlaces, Rounding rounding);
+
+  /**
+   * Compute the number (-)significand * 10^exponent with the given decimal places, where
+   * nextDigit is the first of the digits truncated from the significand (if any).
+   */
+  static Maybe<Decimal> fromDigits(uint64_t significand, int32_t exponent, bool negative, bool truncated, uint8_t nextDigit, uint8_t decimalPlaces);
 };
 
+/**
+ * Arithmetic on results of Decimal arithmetic, which are empty if any operand is.
+ */
+inline Maybe<Decimal> operator+(const Maybe<Decimal>& a, const Maybe<Decimal>& b) {
+  if (!a.available() || !b.available()) {
+    return {};
+  }
+  return a.get() + b.get();
+}
+
+inline Maybe<Decimal> operator-(const Maybe<Decimal>& a, const Maybe<Decimal>& b) {
+  if (!a.available() || !b.available()) {
+    return {};
+  }
+  return a.get() - b.get();
+}
+
+inline Maybe<Decimal> operator*(const Maybe<Decimal>& a, const Maybe<Decimal>& b) {
+  if (!a.available() || !b.available()) {
+    return {};
+  }
+  return a.get() * b.get();
+}
+
+inline Maybe<Decimal> operator/(const Maybe<Decimal>& a, const Maybe<Decimal>& b) {
+  if (!a.available() || !b.available()) {
+    return {};
+  }
+  return a.get() / b.get();
+}
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "Encoding.h"
+
+namespace toolbox {
+
+namespace encoding {
+
+namespace {
+
+constexpr uint32_t ONES_32 = 0x01010101u;
+constexpr uint32_t HIGH_BITS_32 = 0x80808080u;
+constexpr uint64_t ONES_64 = 0x0101010101010101ull;
+constexpr uint64_t HIGH_BITS_64 = 0x8080808080808080ull;
+
+/**
+ * Get the highest bit in each byte of the word which is an ASCII character in the range
+ * [first, last].
+ */
+template<typename W>
+inline W inRange(W word, char first, char last) {
+  constexpr W ones = W(~W(0)) / 0xFFu;
+  constexpr W highBits = ones * 0x80u;
+  const W heptets = word & ~highBits;
+  const W aboveFirst = heptets + ones * W(0x80 - first);
+  const W aboveLast = heptets + ones * W(0x80 - last - 1);
+  return (aboveFirst ^ aboveLast) & ~word & highBits;
+}
+
+/**
+ * Add the bytes of two words without carries between them (modulo 256).
+ */
+inline uint32_t addBytes(uint32_t a, uint32_t b) {
+  return ((a & ~HIGH_BITS_32) + (b & ~HIGH_BITS_32)) ^ ((a ^ b) & HIGH_BITS_32);
+}
+
+/**
+ * Expand the highest bit of each byte to the whole byte.
+ */
+inline uint32_t byteMask(uint32_t highBits) {
+  return (highBits >> 7) * 0xFFu;
+}
+
+/**
+ * Map four 6 bit values (one in each byte) to the characters of the base64 alphabet,
+ * adding the offset of each range of the alphabet in which the value is, branch-free.
+ */
+inline uint32_t base64Chars(uint32_t values) {
+  const uint32_t from26 = ((values + ONES_32 * (0x80u - 26u)) & HIGH_BITS_32) >> 7;
+  const uint32_t from52 = ((values + ONES_32 * (0x80u - 52u)) & HIGH_BITS_32) >> 7;
+  const uint32_t from62 = ((values + ONES_32 * (0x80u - 62u)) & HIGH_BITS_32) >> 7;
+  const uint32_t from63 = ((values + ONES_32 * (0x80u - 63u)) & HIGH_BITS_32) >> 7;
+  // The result is in 0..255 in each byte, so there are no carries between the bytes overall.
+  return values + ONES_32 * 'A' + from26 * 6u - from52 * 75u - from62 * 15u + from63 * 3u;
+}
+
+inline void encodeBase64Group(char* dest, uint32_t group) {
+  const uint32_t values = (group >> 18) | (((group >> 12) & 0x3Fu) << 8) | (((group >> 6) & 0x3Fu) << 16) | ((group & 0x3Fu) << 24);
+  const uint32_t chars = base64Chars(values);
+  memcpy(dest, &chars, sizeof(chars));
+}
+
+}
+
+void encodeHex_W(char* dest, const uint8_t* data, size_t size, bool upperCase) {
+  const uint64_t letterOffset = upperCase ? 'A' - '0' - 10 : 'a' - '0' - 10;
+  while (size >= sizeof(uint32_t)) {
+    uint32_t bytes;
+    memcpy(&bytes, data, sizeof(bytes));
+    // Spread the bytes to 16 bit lanes, then their high and low nibbles to separate bytes
+    uint64_t word = bytes;
+    word = (word | (word << 16)) & 0x0000FFFF0000FFFFull;
+    word = (word | (word << 8)) & 0x00FF00FF00FF00FFull;
+    const uint64_t nibbles = ((word >> 4) & 0x000F000F000F000Full) | ((word & 0x000F000F000F000Full) << 8);
+    const uint64_t letters = ((nibbles + ONES_64 * 6u) >> 4) & ONES_64;
+    const uint64_t chars = nibbles + ONES_64 * '0' + letters * letterOffset;
+    memcpy(dest, &chars, sizeof(chars));
+    data += sizeof(uint32_t);
+    dest += sizeof(uint64_t);
+    size -= sizeof(uint32_t);
+  }
+
+  while (size > 0) {
+    // Same for the nibbles of a single byte in two 8 bit lanes
+    const uint32_t nibbles = (*data >> 4) | ((*data & 0x0Fu) << 8);
+    const uint32_t letters = ((nibbles + 0x0606u) >> 4) & 0x0101u;
+    const uint32_t chars = nibbles + 0x3030u + letters * uint32_t(letterOffset);
+    *dest++ = char(chars);
+    *dest++ = char(chars >> 8);
+    ++data;
+    --size;
+  }
+}
+
+size_t decodeHex_W(uint8_t* dest, const char* str, size_t length) {
+  const char* start = str;
+  while (length >= sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, str, sizeof(word));
+    const uint64_t digits = inRange(word, '0', '9');
+    const uint64_t letters = inRange(word | (ONES_64 * 0x20u), 'a', 'f');
+    if ((digits | letters) != HIGH_BITS_64) {
+      break;
+    }
+    // The low nibble of digits is their value, the one of letters is 9 less.
+    const uint64_t nibbles = (word & (ONES_64 * 0x0Fu)) + (letters >> 7) * 9u;
+    uint64_t bytes = ((nibbles << 4) | (nibbles >> 8)) & 0x00FF00FF00FF00FFull;
+    bytes = (bytes | (bytes >> 8)) & 0x0000FFFF0000FFFFull;
+    bytes = bytes | (bytes >> 16);
+    dest[0] = uint8_t(bytes);
+    dest[1] = uint8_t(bytes >> 8);
+    dest[2] = uint8_t(bytes >> 16);
+    dest[3] = uint8_t(bytes >> 24);
+    str += sizeof(uint64_t);
+    dest += sizeof(uint32_t);
+    length -= sizeof(uint64_t);
+  }
+
+  while (length >= 2) {
+    const uint8_t high = hexDigitValue(str[0]);
+    const uint8_t low = hexDigitValue(str[1]);
+    if ((high | low) > 0x0Fu) {
+      break;
+    }
+    *dest++ = uint8_t((high << 4) | low);
+    str += 2;
+    length -= 2;
+  }
+  return str - start;
+}
+
+size_t encodeBase64_W(char* dest, const uint8_t* data, size_t size) {
+  const char* start = dest;
+  while (size >= 3) {
+    encodeBase64Group(dest, (uint32_t(data[0]) << 16) | (uint32_t(data[1]) << 8) | data[2]);
+    data += 3;
+    dest += 4;
+    size -= 3;
+  }
+
+  if (size > 0) {
+    encodeBase64Group(dest, (uint32_t(data[0]) << 16) | (size > 1 ? uint32_t(data[1]) << 8 : 0u));
+    dest[3] = '=';
+    if (size == 1) {
+      dest[2] = '=';
+    }
+    dest += 4;
+  }
+  return dest - start;
+}
+
+size_t decodeBase64_W(uint8_t* dest, const char* str, size_t length) {
+  const char* start = str;
+  while (length >= sizeof(uint32_t)) {
+    uint32_t word;
+    memcpy(&word, str, sizeof(word));
+    const uint32_t upper = inRange(word, 'A', 'Z');
+    const uint32_t lower = inRange(word, 'a', 'z');
+    const uint32_t digits = inRange(word, '0', '9');
+    const uint32_t plus = inRange(word, '+', '+');
+    const uint32_t slash = inRange(word, '/', '/');
+    if ((upper | lower | digits | plus | slash) != HIGH_BITS_32) {
+      break;
+    }
+    const uint32_t offsets = (byteMask(upper) & ONES_32 * uint8_t(-'A'))
+        | (byteMask(lower) & ONES_32 * uint8_t(26 - 'a'))
+        | (byteMask(digits) & ONES_32 * uint8_t(52 - '0'))
+        | (byteMask(plus) & ONES_32 * uint8_t(62 - '+'))
+        | (byteMask(slash) & ONES_32 * uint8_t(63 - '/'));
+    const uint32_t values = addBytes(word, offsets);
+    const uint32_t group = ((values & 0xFFu) << 18) | (((values >> 8) & 0xFFu) << 12) | (((values >> 16) & 0xFFu) << 6) | (values >> 24);
+    dest[0] = uint8_t(group >> 16);
+    dest[1] = uint8_t(group >> 8);
+    dest[2] = uint8_t(group);
+    str += sizeof(uint32_t);
+    dest += 3;
+    length -= sizeof(uint32_t);
+  }
+  return str - start;
+}
+
+size_t decodeBase64Tail_W(uint8_t* dest, const char* str, size_t length) {
+  if (length < 2 || length > 3) {
+    return 0;
+  }
+  char group[4] = {'A', 'A', 'A', 'A'};
+  memcpy(group, str, length);
+  uint8_t bytes[3];
+  if (decodeBase64_W(bytes, group, sizeof(group)) != sizeof(group)) {
+    return 0;
+  }
+  memcpy(dest, bytes, length - 1);
+  return length - 1;
+}
+
+}
+
+}
@@ -0,0 +1,573 @@
+#ifndef TOOLBOX_ENCODING_H_
+#define TOOLBOX_ENCODING_H_
+
+#include "String.h"
+#include "Streams.h"
+#include "Maybe.h"
+#include <assert.h>
+
+namespace toolbox {
+
+namespace encoding {
+
+/**
+ * Value of a hexadecimal digit, or UINT8_MAX for other characters.
+ */
+inline uint8_t hexDigitValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  c |= 0x20;
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return UINT8_MAX;
+}
+
+/**
+ * Length of size bytes encoded in hex.
+ */
+constexpr size_t hexLength(size_t size) {
+  return 2u * size;
+}
+
+/**
+ * Length of size bytes encoded in base64 (with padding).
+ */
+constexpr size_t base64Length(size_t size) {
+  return (size + 2u) / 3u * 4u;
+}
+
+/**
+ * Encode size bytes in RAM as 2 * size hex digits, four bytes at a time.
+ */
+void encodeHex_W(char* dest, const uint8_t* data, size_t size, bool upperCase);
+
+/**
+ * Decode pairs of hex digits (in either case) in RAM, eight digits at a time.
+ *
+ * Returns the number of characters decoded, which is less than length at the first
+ * pair with an invalid character.
+ */
+size_t decodeHex_W(uint8_t* dest, const char* str, size_t length);
+
+/**
+ * Encode size bytes in RAM in base64 (standard alphabet, with padding), a group of
+ * three bytes at a time.
+ *
+ * Returns the number of characters written, see base64Length().
+ */
+size_t encodeBase64_W(char* dest, const uint8_t* data, size_t size);
+
+/**
+ * Decode groups of four base64 characters (without padding) in RAM.
+ *
+ * Returns the number of characters decoded, which is less than length at the first
+ * group with an invalid character or padding.
+ */
+size_t decodeBase64_W(uint8_t* dest, const char* str, size_t length);
+
+/**
+ * Decode the incomplete last group of 2 or 3 base64 characters (without padding) in RAM.
+ *
+ * Returns the number of bytes decoded, or 0 if a character is invalid.
+ */
+size_t decodeBase64Tail_W(uint8_t* dest, const char* str, size_t length);
+
+/**
+ * Decode a complete group of four base64 characters, which may end with padding.
+ *
+ * Returns the number of bytes decoded, or 0 if a character is invalid.
+ */
+inline size_t decodeBase64Group(uint8_t* dest, const char* group) {
+  if (group[3] != '=') {
+    return decodeBase64_W(dest, group, 4u) == 4u ? 3u : 0u;
+  }
+  return decodeBase64Tail_W(dest, group, group[2] == '=' ? 2u : 3u);
+}
+
+/**
+ * Size of the stack buffers for encoded characters when encoding to outputs or decoding
+ * from inputs (a multiple of 4).
+ */
+constexpr size_t STREAM_BLOCK_SIZE = 48u;
+
+inline const uint8_t* asBytes(const char* data) {
+  return reinterpret_cast<const uint8_t*>(data);
+}
+
+/**
+ * Encode the bytes of data (e.g. a blob in PROGMEM) in hex into buffer, without a
+ * terminating zero.
+ *
+ * Returns the number of characters written, or 0 if the buffer is too small.
+ */
+template<typename Tag>
+size_t encodeHex(const basic_strref<Tag>& data, char* buffer, size_t size, bool upperCase = false) {
+  const size_t length = hexLength(data.length());
+  if (length > size) {
+    return 0;
+  }
+  char block[PROGMEM_BLOCK_SIZE];
+  for (size_t offset = 0; offset < data.length();) {
+    const size_t blockSize = min(data.length() - offset, Tag::BLOCK_SIZE);
+    encodeHex_W(buffer + hexLength(offset), asBytes(Tag::block(data.data() + offset, blockSize, block)), blockSize, upperCase);
+    offset += blockSize;
+  }
+  return length;
+}
+
+inline size_t encodeHex(const strref& data, char* buffer, size_t size, bool upperCase = false) {
+  return data.visit([=] (auto view) { return encodeHex(view, buffer, size, upperCase); });
+}
+
+/**
+ * Encode the bytes of data in hex to the given output, in blocks.
+ *
+ * Returns the number of characters written.
+ */
+template<typename Tag>
+size_t encodeHex(const basic_strref<Tag>& data, IOutput& output, bool upperCase = false) {
+  char block[STREAM_BLOCK_SIZE / 2u];
+  char chars[STREAM_BLOCK_SIZE];
+  size_t written = 0;
+  for (size_t offset = 0; offset < data.length();) {
+    const size_t blockSize = min(data.length() - offset, sizeof(block));
+    encodeHex_W(chars, asBytes(Tag::block(data.data() + offset, blockSize, block)), blockSize, upperCase);
+    const size_t length = output.write(strref{chars, hexLength(blockSize)});
+    written += length;
+    if (length != hexLength(blockSize)) {
+      break;
+    }
+    offset += blockSize;
+  }
+  return written;
+}
+
+inline size_t encodeHex(const strref& data, IOutput& output, bool upperCase = false) {
+  return data.visit([&output, upperCase] (auto view) { return encodeHex(view, output, upperCase); });
+}
+
+/**
+ * Decode a string of hex digits (in either case) into buffer.
+ *
+ * Returns the number of bytes, or nothing if the string has an odd length, an invalid
+ * character or if the buffer is too small.
+ */
+template<typename Tag>
+Maybe<size_t> decodeHex(const basic_strref<Tag>& string, uint8_t* buffer, size_t size) {
+  const size_t length = string.length();
+  if (length % 2u != 0u || length / 2u > size) {
+    return {};
+  }
+  char block[PROGMEM_BLOCK_SIZE];
+  for (size_t offset = 0; offset < length;) {
+    const size_t blockSize = min(length - offset, Tag::BLOCK_SIZE);
+    if (decodeHex_W(buffer + offset / 2u, Tag::block(string.data() + offset, blockSize, block), blockSize) != blockSize) {
+      return {};
+    }
+    offset += blockSize;
+  }
+  return length / 2u;
+}
+
+inline Maybe<size_t> decodeHex(const strref& string, uint8_t* buffer, size_t size) {
+  return string.visit([=] (auto view) { return decodeHex(view, buffer, size); });
+}
+
+/**
+ * Encode the bytes of data in base64 (with padding) into buffer, without a terminating
+ * zero.
+ *
+ * Returns the number of characters written, or 0 if the buffer is too small.
+ */
+template<typename Tag>
+size_t encodeBase64(const basic_strref<Tag>& data, char* buffer, size_t size) {
+  const size_t length = base64Length(data.length());
+  if (length > size) {
+    return 0;
+  }
+  char block[PROGMEM_BLOCK_SIZE];
+  size_t written = 0;
+  for (size_t offset = 0; offset < data.length();) {
+    const size_t blockSize = min(data.length() - offset, Tag::BLOCK_SIZE / 3u * 3u);
+    written += encodeBase64_W(buffer + written, asBytes(Tag::block(data.data() + offset, blockSize, block)), blockSize);
+    offset += blockSize;
+  }
+  return length;
+}
+
+inline size_t encodeBase64(const strref& data, char* buffer, size_t size) {
+  return data.visit([=] (auto view) { return encodeBase64(view, buffer, size); });
+}
+
+/**
+ * Encode the bytes of data in base64 (with padding) to the given output, in blocks.
+ *
+ * Returns the number of characters written.
+ */
+template<typename Tag>
+size_t encodeBase64(const basic_strref<Tag>& data, IOutput& output) {
+  char block[STREAM_BLOCK_SIZE / 4u * 3u];
+  char chars[STREAM_BLOCK_SIZE];
+  size_t written = 0;
+  for (size_t offset = 0; offset < data.length();) {
+    const size_t blockSize = min(data.length() - offset, sizeof(block));
+    const size_t encoded = encodeBase64_W(chars, asBytes(Tag::block(data.data() + offset, blockSize, block)), blockSize);
+    const size_t length = output.write(strref{chars, encoded});
+    written += length;
+    if (length != encoded) {
+      break;
+    }
+    offset += blockSize;
+  }
+  return written;
+}
+
+inline size_t encodeBase64(const strref& data, IOutput& output) {
+  return data.visit([&output] (auto view) { return encodeBase64(view, output); });
+}
+
+/**
+ * Decode a base64 string (standard alphabet, padding is optional) into buffer.
+ *
+ * Returns the number of bytes, or nothing if the string has an invalid length or
+ * character or if the buffer is too small.
+ */
+template<typename Tag>
+Maybe<size_t> decodeBase64(const basic_strref<Tag>& string, uint8_t* buffer, size_t size) {
+  size_t length = string.length();
+  if (length % 4u == 0u && length > 0u && string.charAt(length - 1u) == '=') {
+    length -= string.charAt(length - 2u) == '=' ? 2u : 1u;
+  }
+  const size_t tail = length % 4u;
+  const size_t decodedLength = length / 4u * 3u + (tail > 0u ? tail - 1u : 0u);
+  if (tail == 1u || decodedLength > size) {
+    return {};
+  }
+
+  char block[PROGMEM_BLOCK_SIZE];
+  size_t decoded = 0;
+  for (size_t offset = 0; offset < length - tail;) {
+    const size_t blockSize = min(length - tail - offset, Tag::BLOCK_SIZE / 4u * 4u);
+    if (decodeBase64_W(buffer + decoded, Tag::block(string.data() + offset, blockSize, block), blockSize) != blockSize) {
+      return {};
+    }
+    decoded += blockSize / 4u * 3u;
+    offset += blockSize;
+  }
+  if (tail > 0u && decodeBase64Tail_W(buffer + decoded, Tag::block(string.data() + length - tail, tail, block), tail) == 0u) {
+    return {};
+  }
+  return decodedLength;
+}
+
+inline Maybe<size_t> decodeBase64(const strref& string, uint8_t* buffer, size_t size) {
+  return string.visit([=] (auto view) { return decodeBase64(view, buffer, size); });
+}
+
+}
+
+/**
+ * Output which hex encodes the data written to it into another output, without
+ * buffering.
+ */
+class HexOutput final : public IOutput {
+  IOutput& _output;
+  bool _upperCase;
+
+public:
+  explicit HexOutput(IOutput& output, bool upperCase = false) : _output(output), _upperCase(upperCase) {}
+
+  size_t write(char c) override {
+    return write(strref{&c, 1u});
+  }
+
+  /**
+   * Returns the number of bytes which were written completely encoded.
+   */
+  size_t write(const strref& data) override {
+    return encoding::encodeHex(data, _output, _upperCase) / 2u;
+  }
+
+#ifdef TOOLBOX_IOUTPUT_IINPUT_SUPPORT
+  size_t write(IInput& input) override {
+    char block[encoding::STREAM_BLOCK_SIZE];
+    size_t written = 0;
+    while (input.available()) {
+      const size_t length = input.read(block, sizeof(block));
+      const size_t encoded = write(strref{block, length});
+      written += encoded;
+      if (length == 0u || encoded != length) {
+        break;
+      }
+    }
+    return written;
+  }
+#endif
+};
+
+/**
+ * Output which base64 encodes the data written to it into another output.
+ *
+ * It keeps up to two bytes of an incomplete group of three bytes until more data is
+ * written, so finish() has to be called after writing all data to write them (with
+ * padding).
+ */
+class Base64Output final : public IOutput {
+  IOutput& _output;
+  char _pending[3];
+  uint8_t _pendingCount;
+
+  template<typename Tag>
+  size_t writeData(const basic_strref<Tag>& data) {
+    size_t consumed = 0;
+    if (_pendingCount > 0u) {
+      while (_pendingCount < 3u && consumed < data.length()) {
+        _pending[_pendingCount++] = data.charAt(consumed++);
+      }
+      if (_pendingCount < 3u) {
+        return consumed;
+      }
+      _pendingCount = 0u;
+      if (encoding::encodeBase64(ram_strref{_pending, 3u}, _output) != 4u) {
+        return 0;
+      }
+    }
+
+    const size_t groups = (data.length() - consumed) / 3u * 3u;
+    const size_t written = encoding::encodeBase64(data.substring(consumed, groups), _output);
+    if (written != encoding::base64Length(groups)) {
+      return consumed + written / 4u * 3u;
+    }
+    consumed += groups;
+    while (consumed < data.length()) {
+      _pending[_pendingCount++] = data.charAt(consumed++);
+    }
+    return consumed;
+  }
+
+public:
+  explicit Base64Output(IOutput& output) : _output(output), _pending(), _pendingCount(0u) {}
+
+  size_t write(char c) override {
+    return write(strref{&c, 1u});
+  }
+
+  /**
+   * Returns the number of bytes which were written completely encoded or are kept
+   * until the group is complete.
+   */
+  size_t write(const strref& data) override {
+    return data.visit([this] (auto view) { return writeData(view); });
+  }
+
+#ifdef TOOLBOX_IOUTPUT_IINPUT_SUPPORT
+  size_t write(IInput& input) override {
+    char block[encoding::STREAM_BLOCK_SIZE];
+    size_t written = 0;
+    while (input.available()) {
+      const size_t length = input.read(block, sizeof(block));
+      const size_t encoded = write(strref{block, length});
+      written += encoded;
+      if (length == 0u || encoded != length) {
+        break;
+      }
+    }
+    return written;
+  }
+#endif
+
+  /**
+   * Write the remaining bytes of the last group with padding.
+   *
+   * Returns the number of characters written.
+   */
+  size_t finish() {
+    const size_t count = _pendingCount;
+    _pendingCount = 0u;
+    return encoding::encodeBase64(ram_strref{_pending, count}, _output);
+  }
+};
+
+/**
+ * Input which decodes the hex digits read from another input.
+ *
+ * Reading stops at the first invalid character, see failed().
+ */
+class HexInput final : public IInput {
+  IInput& _input;
+  char _pending;
+  bool _hasPending;
+  bool _failed;
+
+public:
+  explicit HexInput(IInput& input) : _input(input), _pending(), _hasPending(false), _failed(false) {}
+
+  /**
+   * Whether an invalid character (or an odd number of characters) was read.
+   */
+  bool failed() const {
+    return _failed;
+  }
+
+  size_t available() const override {
+    return _failed ? 0u : (_input.available() + (_hasPending ? 1u : 0u)) / 2u;
+  }
+
+  size_t read(char* buffer, size_t bufferSize) override {
+    char chars[encoding::STREAM_BLOCK_SIZE];
+    size_t length = 0;
+    while (!_failed && length < bufferSize) {
+      size_t count = 0;
+      if (_hasPending) {
+        chars[count++] = _pending;
+        _hasPending = false;
+      }
+      const size_t received = _input.read(chars + count, min(encoding::hexLength(bufferSize - length), sizeof(chars)) - count);
+      count += received;
+
+      const size_t pairs = count & ~size_t(1u);
+      const size_t decoded = encoding::decodeHex_W(reinterpret_cast<uint8_t*>(buffer + length), chars, pairs);
+      length += decoded / 2u;
+      if (decoded != pairs) {
+        _failed = true;
+      } else if (pairs != count) {
+        _pending = chars[pairs];
+        _hasPending = true;
+      }
+      if (received == 0u) {
+        _failed = _failed || (_hasPending && _input.available() == 0u);
+        break;
+      }
+    }
+    return length;
+  }
+
+  size_t readString(char* buffer, size_t bufferSize) override {
+    if (bufferSize == 0u) {
+      return 0;
+    }
+    const size_t length = read(buffer, bufferSize - 1u);
+    buffer[length] = '\0';
+    return length;
+  }
+};
+
+/**
+ * Input which decodes the base64 characters (standard alphabet, padding is optional)
+ * read from another input.
+ *
+ * It keeps up to three characters of an incomplete group and up to two decoded bytes
+ * which did not fit into the buffer of the last read(). Reading stops at the first
+ * invalid character, see failed().
+ *
+ * available() counts padding characters which were not read yet like data, i.e. it may
+ * be up to two bytes more than can be read.
+ */
+class Base64Input final : public IInput {
+  IInput& _input;
+  char _chars[3];
+  uint8_t _charCount;
+  uint8_t _bytes[2];
+  uint8_t _byteCount;
+  bool _failed;
+  bool _finished;
+
+  static size_t decodedLength(size_t length) {
+    return length / 4u * 3u + (length % 4u > 1u ? length % 4u - 1u : 0u);
+  }
+
+  /**
+   * Copy decoded bytes to the buffer as far as they fit, keeping the rest.
+   */
+  size_t deliver(const uint8_t* bytes, size_t count, char* buffer, size_t bufferSize) {
+    const size_t length = min(count, bufferSize);
+    memcpy(buffer, bytes, length);
+    _byteCount = uint8_t(count - length);
+    memcpy(_bytes, bytes + length, _byteCount);
+    return length;
+  }
+
+public:
+  explicit Base64Input(IInput& input) : _input(input), _chars(), _charCount(0u), _bytes(), _byteCount(0u), _failed(false), _finished(false) {}
+
+  /**
+   * Whether an invalid character (or a group with a single character) was read.
+   */
+  bool failed() const {
+    return _failed;
+  }
+
+  size_t available() const override {
+    if (_failed || _finished) {
+      return _byteCount;
+    }
+    return _byteCount + decodedLength(_charCount + _input.available());
+  }
+
+  size_t read(char* buffer, size_t bufferSize) override {
+    size_t length = deliver(_bytes, _byteCount, buffer, bufferSize);
+
+    char chars[encoding::STREAM_BLOCK_SIZE];
+    while (!_failed && !_finished && length < bufferSize) {
+      size_t count = _charCount;
+      memcpy(chars, _chars, count);
+      // Read only the groups needed to fill the buffer, so at most one has to be kept
+      const size_t groups = (bufferSize - length + 2u) / 3u;
+      const size_t received = _input.read(chars + count, min(groups * 4u, sizeof(chars)) - count);
+      count += received;
+
+      const size_t fitting = min(count / 4u, (bufferSize - length) / 3u) * 4u;
+      size_t position = encoding::decodeBase64_W(reinterpret_cast<uint8_t*>(buffer + length), chars, fitting);
+      length += position / 4u * 3u;
+
+      // A group with padding or invalid characters, or one which does not fit
+      if (position + 4u <= count) {
+        uint8_t bytes[3];
+        const size_t decoded = encoding::decodeBase64Group(bytes, chars + position);
+        _failed = decoded == 0u;
+        _finished = decoded > 0u && decoded < 3u;
+        length += deliver(bytes, decoded, buffer + length, bufferSize - length);
+        position += 4u;
+        _failed = _failed || (_finished && position < count);
+      }
+      if (_failed || _finished) {
+        // Nothing more is decoded, the remaining characters are dropped
+        _charCount = 0u;
+        break;
+      }
+      // Only the groups needed were read, so at most a partial group is left
+      assert(count - position < 4u);
+      _charCount = uint8_t(count - position);
+      memcpy(_chars, chars + position, _charCount);
+
+      if (received == 0u) {
+        if (_input.available() == 0u && _charCount > 0u) {
+          // Incomplete last group without padding
+          uint8_t bytes[2];
+          const size_t decoded = encoding::decodeBase64Tail_W(bytes, _chars, _charCount);
+          _failed = decoded == 0u;
+          _finished = true;
+          _charCount = 0u;
+          length += deliver(bytes, decoded, buffer + length, bufferSize - length);
+        }
+        break;
+      }
+    }
+    return length;
+  }
+
+  size_t readString(char* buffer, size_t bufferSize) override {
+    if (bufferSize == 0u) {
+      return 0;
+    }
+    const size_t length = read(buffer, bufferSize - 1u);
+    buffer[length] = '\0';
+    return length;
+  }
+};
+
+}
+
+#endif
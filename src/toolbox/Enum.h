@@ -0,0 +1,392 @@
+#ifndef TOOLBOX_ENUM_H_
+#define TOOLBOX_ENUM_H_
+
+#include "Conversion.h"
+
+namespace toolbox {
+
+/**
+ * Name of a value of enum E, see enum_names.
+ */
+template<typename E>
+struct enum_name final {
+  E value;
+  const char* name;
+};
+
+/**
+ * Names of the values of enum E, which enable convert<E>. Specialize it with a constexpr
+ * array of name/value pairs named entries, e.g.
+ *
+ *   enum struct Command : uint8_t { Start, Stop, Reset };
+ *
+ *   template<>
+ *   struct toolbox::enum_names<Command> {
+ *     static constexpr toolbox::enum_name<Command> entries[] = {
+ *       {Command::Start, "start"},
+ *       {Command::Stop, "stop"},
+ *       {Command::Reset, "reset"},
+ *     };
+ *   };
+ *
+ * The names must be distinct, non-empty and consist of letters, digits, '_', '-' and
+ * '.' only. The values must be dense (like consecutive values), several names for the
+ * same value are allowed. The entries are only used at compile time, see enum_table.
+ */
+template<typename E>
+struct enum_names {};
+
+namespace keywords {
+
+/**
+ * Characters allowed in names, which also end a name when parsing.
+ */
+constexpr bool isKeywordChar(char c) {
+  return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == '-' || c == '.';
+}
+
+/**
+ * Array which can be created by constexpr functions (and placed in PROGMEM).
+ */
+template<typename T, size_t N>
+struct table final {
+  T data[N];
+};
+
+template<typename E>
+constexpr size_t count() {
+  return sizeof(enum_names<E>::entries) / sizeof(enum_names<E>::entries[0]);
+}
+
+constexpr size_t nameLength(const char* name) {
+  size_t length = 0;
+  while (name[length] != '\0') {
+    ++length;
+  }
+  return length;
+}
+
+constexpr bool equalNames(const char* a, const char* b) {
+  while (*a != '\0' && *a == *b) {
+    ++a;
+    ++b;
+  }
+  return *a == *b;
+}
+
+template<typename E>
+constexpr bool validNames() {
+  const auto& entries = enum_names<E>::entries;
+  for (size_t i = 0; i < count<E>(); ++i) {
+    const char* name = entries[i].name;
+    if (name[0] == '\0') {
+      return false;
+    }
+    for (size_t j = 0; name[j] != '\0'; ++j) {
+      if (!isKeywordChar(name[j])) {
+        return false;
+      }
+    }
+    for (size_t j = 0; j < i; ++j) {
+      if (equalNames(name, entries[j].name)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Length of all names including their terminators.
+ */
+template<typename E>
+constexpr size_t namesLength() {
+  size_t length = 0;
+  for (size_t i = 0; i < count<E>(); ++i) {
+    length += nameLength(enum_names<E>::entries[i].name) + 1u;
+  }
+  return length;
+}
+
+template<typename E>
+constexpr table<char, namesLength<E>()> concatenatedNames() {
+  table<char, namesLength<E>()> names {};
+  size_t position = 0;
+  for (size_t i = 0; i < count<E>(); ++i) {
+    for (const char* name = enum_names<E>::entries[i].name; *name != '\0'; ++name) {
+      names.data[position++] = *name;
+    }
+    names.data[position++] = '\0';
+  }
+  return names;
+}
+
+template<typename E>
+constexpr table<uint16_t, count<E>() + 1u> nameOffsets() {
+  table<uint16_t, count<E>() + 1u> offsets {};
+  for (size_t i = 0; i < count<E>(); ++i) {
+    offsets.data[i + 1u] = uint16_t(offsets.data[i] + nameLength(enum_names<E>::entries[i].name) + 1u);
+  }
+  return offsets;
+}
+
+template<typename E>
+constexpr table<E, count<E>()> values() {
+  table<E, count<E>()> values {};
+  for (size_t i = 0; i < count<E>(); ++i) {
+    values.data[i] = enum_names<E>::entries[i].value;
+  }
+  return values;
+}
+
+template<typename E>
+constexpr std::underlying_type_t<E> minValue() {
+  using U = std::underlying_type_t<E>;
+  U value = U(enum_names<E>::entries[0].value);
+  for (size_t i = 1; i < count<E>(); ++i) {
+    const U other = U(enum_names<E>::entries[i].value);
+    value = other < value ? other : value;
+  }
+  return value;
+}
+
+template<typename E>
+constexpr std::underlying_type_t<E> maxValue() {
+  using U = std::underlying_type_t<E>;
+  U value = U(enum_names<E>::entries[0].value);
+  for (size_t i = 1; i < count<E>(); ++i) {
+    const U other = U(enum_names<E>::entries[i].value);
+    value = other > value ? other : value;
+  }
+  return value;
+}
+
+/**
+ * Index of the (first) entry of each value from the smallest to the largest one.
+ */
+template<typename E, typename Index, size_t RANGE>
+constexpr table<Index, RANGE> indexByValue(Index none) {
+  using U = std::underlying_type_t<E>;
+  table<Index, RANGE> indices {};
+  for (size_t i = 0; i < RANGE; ++i) {
+    indices.data[i] = none;
+  }
+  for (size_t i = count<E>(); i > 0u; --i) {
+    indices.data[size_t(U(enum_names<E>::entries[i - 1u].value) - minValue<E>())] = Index(i - 1u);
+  }
+  return indices;
+}
+
+/**
+ * Multiplicative hash mapping the hash32() of each name to a distinct slot in a table
+ * of 2^bits slots.
+ */
+struct perfect_hash final {
+  uint32_t multiplier;
+  uint8_t bits;
+
+  constexpr size_t slot(uint32_t hash) const {
+    return (hash * multiplier) >> (32u - bits);
+  }
+};
+
+constexpr uint8_t ceilLog2(size_t value) {
+  uint8_t bits = 0;
+  while ((size_t(1) << bits) < value) {
+    ++bits;
+  }
+  return bits;
+}
+
+/**
+ * Slot table sizes tried, starting from the smallest one (number of additional bits).
+ */
+constexpr uint8_t PERFECT_HASH_EXTRA_BITS = 3u;
+/**
+ * Multipliers tried for each table size.
+ */
+constexpr uint32_t PERFECT_HASH_ATTEMPTS = 1024u;
+
+/**
+ * Search for a perfect hash of the names at compile time, trying multipliers for
+ * increasingly large tables until no two names share a slot.
+ *
+ * Returns bits == 0 if there is none.
+ */
+template<typename E>
+constexpr perfect_hash findPerfectHash() {
+  constexpr size_t N = count<E>();
+  constexpr uint8_t MIN_BITS = N > 1u ? ceilLog2(N) : 1u;
+  uint32_t hashes[N] {};
+  for (size_t i = 0; i < N; ++i) {
+    const char* name = enum_names<E>::entries[i].name;
+    hashes[i] = hash32(name, nameLength(name));
+  }
+
+  // Slots are marked with the number of the attempt instead of clearing them for each one.
+  uint32_t marks[size_t(1) << (MIN_BITS + PERFECT_HASH_EXTRA_BITS)] {};
+  uint32_t attempt = 0;
+  for (uint8_t bits = MIN_BITS; bits <= MIN_BITS + PERFECT_HASH_EXTRA_BITS; ++bits) {
+    for (uint32_t k = 0; k < PERFECT_HASH_ATTEMPTS; ++k) {
+      const perfect_hash hash {0x9E3779B9u * (2u * k + 1u), bits};
+      ++attempt;
+      bool perfect = true;
+      for (size_t i = 0; i < N && perfect; ++i) {
+        const size_t slot = hash.slot(hashes[i]);
+        perfect = marks[slot] != attempt;
+        marks[slot] = attempt;
+      }
+      if (perfect) {
+        return hash;
+      }
+    }
+  }
+  return {0u, 0u};
+}
+
+template<typename Index, size_t SLOTS, typename E>
+constexpr table<Index, SLOTS> slots(perfect_hash hash, Index none) {
+  table<Index, SLOTS> slots {};
+  for (size_t i = 0; i < SLOTS; ++i) {
+    slots.data[i] = none;
+  }
+  for (size_t i = 0; i < count<E>(); ++i) {
+    const char* name = enum_names<E>::entries[i].name;
+    slots.data[hash.slot(hash32(name, nameLength(name)))] = Index(i);
+  }
+  return slots;
+}
+
+template<typename T>
+T readProgmem(const T& value) {
+  T result;
+  memcpy_P(&result, &value, sizeof(result));
+  return result;
+}
+
+}
+
+/**
+ * Lookup tables between the names and values of enum E, generated at compile time from
+ * enum_names<E> and placed in PROGMEM.
+ *
+ * Looking up a name takes one hash of the name and one comparison with the name in the
+ * slot of a perfect hash table. Looking up the name of a value is an index into a table.
+ */
+template<typename E>
+class enum_table final {
+  static_assert(std::is_enum<E>::value, "enum_table requires an enum type");
+  static_assert(keywords::count<E>() > 0u, "enum_names must have entries");
+  static_assert(keywords::validNames<E>(), "enum_names must be distinct, non-empty and consist of letters, digits, '_', '-' and '.'");
+  static_assert(keywords::namesLength<E>() <= UINT16_MAX, "enum_names are too long");
+
+  using U = std::underlying_type_t<E>;
+  static constexpr size_t COUNT = keywords::count<E>();
+  using Index = std::conditional_t<(COUNT < UINT8_MAX), uint8_t, uint16_t>;
+  static constexpr Index NONE = std::numeric_limits<Index>::max();
+
+  static constexpr U MIN_VALUE = keywords::minValue<E>();
+  static constexpr U MAX_VALUE = keywords::maxValue<E>();
+  static constexpr size_t RANGE = size_t(MAX_VALUE - MIN_VALUE) + 1u;
+  static_assert(RANGE <= 4u * COUNT, "enum_names values must be dense for looking up names by index");
+
+  static constexpr keywords::perfect_hash HASH = keywords::findPerfectHash<E>();
+  static_assert(HASH.bits != 0u, "no perfect hash found for enum_names");
+
+  static constexpr keywords::table<char, keywords::namesLength<E>()> NAMES PROGMEM = keywords::concatenatedNames<E>();
+  static constexpr keywords::table<uint16_t, COUNT + 1u> OFFSETS PROGMEM = keywords::nameOffsets<E>();
+  static constexpr keywords::table<E, COUNT> VALUES PROGMEM = keywords::values<E>();
+  static constexpr keywords::table<Index, RANGE> INDEX_BY_VALUE PROGMEM = keywords::indexByValue<E, Index, RANGE>(NONE);
+  static constexpr keywords::table<Index, size_t(1) << HASH.bits> SLOTS PROGMEM = keywords::slots<Index, size_t(1) << HASH.bits, E>(HASH, NONE);
+
+  static progmem_strref nameAt(size_t index) {
+    const uint16_t offset = keywords::readProgmem(OFFSETS.data[index]);
+    const uint16_t next = keywords::readProgmem(OFFSETS.data[index + 1u]);
+    return {NAMES.data + offset, size_t(next - offset - 1u), true};
+  }
+
+public:
+  static constexpr size_t size() {
+    return COUNT;
+  }
+
+  /**
+   * Name of value (the first one if there are several), or an empty view if it has none.
+   */
+  static progmem_strref name(E value) {
+    const U v = U(value);
+    if (v < MIN_VALUE || v > MAX_VALUE) {
+      return {};
+    }
+    const Index index = keywords::readProgmem(INDEX_BY_VALUE.data[size_t(v - MIN_VALUE)]);
+    return index != NONE ? nameAt(index) : progmem_strref{};
+  }
+
+  /**
+   * Value with exactly the given name.
+   */
+  template<typename Tag>
+  static Maybe<E> find(const basic_strref<Tag>& name) {
+    const Index index = keywords::readProgmem(SLOTS.data[HASH.slot(name.hash())]);
+    if (index == NONE || nameAt(index) != name) {
+      return {};
+    }
+    return keywords::readProgmem(VALUES.data[index]);
+  }
+
+  /**
+   * Parse a name after optional whitespace from the start of a typed view. It ends
+   * before the first character which is not allowed in names. On success, position is
+   * set to the index after the name.
+   */
+  template<typename Tag>
+  static Maybe<E> parse(const basic_strref<Tag>& string, size_t& position) {
+    const size_t length = string.length();
+    size_t start = 0;
+    while (start < length && parsing::isSpace(string.charAt(start))) {
+      ++start;
+    }
+    size_t end = start;
+    while (end < length && keywords::isKeywordChar(string.charAt(end))) {
+      ++end;
+    }
+    if (end == start) {
+      return {};
+    }
+    Maybe<E> value = find(string.substring(start, end - start));
+    if (value.available()) {
+      position = end;
+    }
+    return value;
+  }
+};
+
+/**
+ * Conversion of enums with names (see enum_names) using the tables of enum_table.
+ *
+ * In contrast to other converters, the result of toString() is a view of the name in
+ * PROGMEM, which stays valid.
+ */
+template<typename E>
+struct convert<E, std::enable_if_t<std::is_enum<E>::value && (sizeof(enum_names<E>::entries) > 0u)>> final {
+  static strref toString(E value) {
+    return enum_table<E>::name(value);
+  }
+
+  static size_t writeTo(E value, IOutput& output) {
+    return output.write(enum_table<E>::name(value));
+  }
+
+  static Maybe<E> fromString(const strref& string, strref* end = nullptr) {
+    size_t position = 0;
+    Maybe<E> value = string.visit([&position] (auto view) { return enum_table<E>::parse(view, position); });
+    if (value.available() && end != nullptr) {
+      *end = string.skip(position);
+    }
+    return value;
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef TOOLBOX_FIXEDSTRING_H_
+#define TOOLBOX_FIXEDSTRING_H_
+
+#include "String.h"
+#include "Conversion.h"
+
+#ifndef ARDUINO_AVR_NANO
+#include <cstdarg>
+#endif
+
+namespace toolbox {
+
+/**
+ * Appendable string with a fixed capacity, stored in place (e.g. on the stack).
+ *
+ * In contrast to str<N>, it keeps track of its length, so converting it to a strref does
+ * not need to scan the string. Contents exceeding the capacity are dropped and the
+ * string is marked as truncated.
+ */
+template<size_t CAPACITY>
+class FixedString final {
+  char _buffer[CAPACITY + 1];
+  size_t _length;
+  bool _truncated;
+
+  size_t available() const {
+    return CAPACITY - _length;
+  }
+
+  template<typename T>
+  FixedString& appendInteger(T value, int base) {
+    if (base != 10) {
+      return append(convert<T>::toString(value, base));
+    }
+    char digits[formatting::MAX_INTEGER_LENGTH];
+    return append(strref{digits, convert<T>::toChars(value, digits, sizeof(digits))});
+  }
+
+public:
+  FixedString() : _buffer{'\0'}, _length(0u), _truncated(false) {}
+
+  FixedString(const strref& string) : FixedString() {
+    append(string);
+  }
+
+  FixedString& operator=(const strref& string) {
+    clear();
+    return append(string);
+  }
+
+  static constexpr size_t capacity() {
+    return CAPACITY;
+  }
+
+  size_t length() const {
+    return _length;
+  }
+
+  bool empty() const {
+    return _length == 0u;
+  }
+
+  bool isTruncated() const {
+    return _truncated;
+  }
+
+  const char* cstr() const {
+    return _buffer;
+  }
+
+  operator strref() const {
+    return {_buffer, _length, true};
+  }
+
+  operator Maybe<strref>() const {
+    return strref{_buffer, _length, true};
+  }
+
+  void clear() {
+    _buffer[0] = '\0';
+    _length = 0u;
+    _truncated = false;
+  }
+
+  FixedString& append(const strref& string) {
+    size_t copied = string.copy(_buffer + _length, available() + 1, true);
+    _length += copied;
+    if (copied < string.length()) {
+      _truncated = true;
+    }
+    return *this;
+  }
+
+  FixedString& append(const char* string) {
+    return append(strref{string});
+  }
+
+  FixedString& append(const __FlashStringHelper* string) {
+    return append(strref{string});
+  }
+
+  FixedString& append(char c) {
+    if (available() > 0u) {
+      _buffer[_length++] = c;
+      _buffer[_length] = '\0';
+    } else {
+      _truncated = true;
+    }
+    return *this;
+  }
+
+  FixedString& append(int value, int base = 10) { return appendInteger(value, base); }
+  FixedString& append(unsigned int value, int base = 10) { return appendInteger(value, base); }
+  FixedString& append(long value, int base = 10) { return appendInteger(value, base); }
+  FixedString& append(unsigned long value, int base = 10) { return appendInteger(value, base); }
+  FixedString& append(bool value, BoolFormat format = BoolFormat::Logic) { return append(convert<bool>::toString(value, format)); }
+
+  /**
+   * Append printf-style formatted contents.
+   *
+   * The format string must be zero-terminated (see Formatter), otherwise nothing is appended.
+   */
+  FixedString& appendf(strref fmt, ...) {
+    if (!fmt.isZeroTerminated()) {
+      return *this;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    int length;
+    if (fmt.isInProgmem()) {
+      length = vsnprintf_P(_buffer + _length, available() + 1, (PGM_P)fmt.fpstr(), args);
+    } else {
+      length = vsnprintf(_buffer + _length, available() + 1, fmt.cstr(), args);
+    }
+    va_end(args);
+
+    if (length > 0) {
+      if (size_t(length) > available()) {
+        _length = CAPACITY;
+        _truncated = true;
+      } else {
+        _length += length;
+      }
+    }
+    _buffer[_length] = '\0';
+    return *this;
+  }
+};
+
+}
+
+#endif
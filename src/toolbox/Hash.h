@@ -0,0 +1,94 @@
+#ifndef TOOLBOX_HASH_H_
+#define TOOLBOX_HASH_H_
+
+#include <Arduino.h>
+
+namespace toolbox {
+
+namespace hashing {
+
+constexpr uint32_t rotl(uint32_t x, uint8_t r) {
+  return (x << r) | (x >> (32u - r));
+}
+
+/**
+ * Read four characters as little-endian word, independent of the alignment and
+ * byte order of the platform (and usable in constant expressions).
+ */
+constexpr uint32_t readWord(const char* data) {
+  return uint32_t(uint8_t(data[0]))
+    | (uint32_t(uint8_t(data[1])) << 8)
+    | (uint32_t(uint8_t(data[2])) << 16)
+    | (uint32_t(uint8_t(data[3])) << 24);
+}
+
+constexpr uint32_t scramble(uint32_t k) {
+  return rotl(k * 0xcc9e2d51u, 15) * 0x1b873593u;
+}
+
+/**
+ * Mix all whole words of data into the hash state h.
+ */
+constexpr uint32_t mixWords(uint32_t h, const char* data, size_t length) {
+  for (size_t i = 0; i + 4u <= length; i += 4u) {
+    h = rotl(h ^ scramble(readWord(data + i)), 13) * 5u + 0xe6546b64u;
+  }
+  return h;
+}
+
+/**
+ * Mix the remaining (up to three) characters after the last whole word and finalize the hash.
+ */
+constexpr uint32_t finalize(uint32_t h, const char* data, size_t length, size_t totalLength) {
+  const char* tail = data + (length & ~size_t(3u));
+  uint32_t k = 0;
+  switch (length & 3u) {
+    case 3: k ^= uint32_t(uint8_t(tail[2])) << 16; // fall through
+    case 2: k ^= uint32_t(uint8_t(tail[1])) << 8; // fall through
+    case 1: k ^= uint32_t(uint8_t(tail[0])); h ^= scramble(k); // fall through
+    default: break;
+  }
+  h ^= uint32_t(totalLength);
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
+
+}
+
+/**
+ * Fast non-cryptographic 32-bit hash of a string in RAM (MurmurHash3, x86_32 variant).
+ *
+ * It processes the string a word (four characters) at a time and can be evaluated
+ * at compile time, e.g. to hash string literals.
+ */
+constexpr uint32_t hash32(const char* data, size_t length, uint32_t seed = 0u) {
+  return hashing::finalize(hashing::mixWords(seed, data, length), data, length, length);
+}
+
+/**
+ * Same hash as hash32(), but for strings in PROGMEM.
+ *
+ * The string is read in blocks into a stack buffer.
+ */
+inline uint32_t hash32_P(PGM_P data, size_t length, uint32_t seed = 0u) {
+  constexpr size_t BLOCK_SIZE = 32u; // must be a multiple of the word size
+  char block[BLOCK_SIZE];
+  uint32_t h = seed;
+  size_t remaining = length;
+  while (remaining > BLOCK_SIZE) {
+    memcpy_P(block, data, BLOCK_SIZE);
+    h = hashing::mixWords(h, block, BLOCK_SIZE);
+    data += BLOCK_SIZE;
+    remaining -= BLOCK_SIZE;
+  }
+  memcpy_P(block, data, remaining);
+  return hashing::finalize(hashing::mixWords(h, block, remaining), block, remaining, length);
+}
+
+}
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef TOOLBOX_INTERNTABLE_H_
+#define TOOLBOX_INTERNTABLE_H_
+
+#include "String.h"
+
+namespace toolbox {
+
+/**
+ * Statistics of an InternTable.
+ */
+struct InternStatistics final {
+  uint32_t lookups = 0u;
+  uint32_t hits = 0u;
+  uint32_t evictions = 0u;
+  uint32_t rejections = 0u;
+  uint32_t bytesSaved = 0u;
+
+  float hitRate() const {
+    return lookups > 0u ? float(hits) / float(lookups) : 0.f;
+  }
+};
+
+/**
+ * Fixed-capacity table of interned strings.
+ *
+ * Interning returns the same shared_str for all strings with equal contents, so
+ * the contents are stored only once and interned strings can be compared by
+ * storage (see shared_str::sharesStorageWith()) instead of by contents.
+ *
+ * Entries are looked up by hash (using open addressing with linear probing). If the
+ * table is full, entries which are not used outside of the table anymore are evicted.
+ * If there are no such entries, the string is materialized without interning it.
+ */
+template<size_t CAPACITY>
+class InternTable final {
+  shared_str _entries[CAPACITY];
+  size_t _size;
+  InternStatistics _statistics;
+
+  size_t findSlot(const strref& string, uint32_t hash) const {
+    size_t i = hash % CAPACITY;
+    for (size_t probes = 0; probes < CAPACITY; ++probes) {
+      const shared_str& entry = _entries[i];
+      if (entry.empty() || (entry.hash() == hash && strref{entry} == string)) {
+        return i;
+      }
+      i = (i + 1u) % CAPACITY;
+    }
+    return CAPACITY;
+  }
+
+  void insert(shared_str&& string) {
+    size_t i = string.hash() % CAPACITY;
+    while (!_entries[i].empty()) {
+      i = (i + 1u) % CAPACITY;
+    }
+    _entries[i] = static_cast<shared_str&&>(string);
+    _size += 1u;
+  }
+
+  /**
+   * Remove the entry in slot i, moving following entries of the probing sequence into
+   * the gap so that they can still be found (without tombstones).
+   */
+  void removeAt(size_t i) {
+    _entries[i].clear();
+    _size -= 1u;
+    for (size_t j = (i + 1u) % CAPACITY; !_entries[j].empty(); j = (j + 1u) % CAPACITY) {
+      const size_t home = _entries[j].hash() % CAPACITY;
+      // The entry stays if its home slot is (cyclically) in (i, j]
+      const bool reachable = i <= j ? (home > i && home <= j) : (home > i || home <= j);
+      if (!reachable) {
+        _entries[i] = static_cast<shared_str&&>(_entries[j]);
+        i = j;
+      }
+    }
+  }
+
+public:
+  InternTable() : _entries(), _size(0u), _statistics() {}
+
+  size_t capacity() const {
+    return CAPACITY;
+  }
+
+  size_t size() const {
+    return _size;
+  }
+
+  const InternStatistics& statistics() const {
+    return _statistics;
+  }
+
+  void resetStatistics() {
+    _statistics = {};
+  }
+
+  /**
+   * Get the canonical shared_str for the contents of the given string.
+   */
+  shared_str intern(const strref& string) {
+    if (string.empty()) {
+      return {};
+    }
+
+    _statistics.lookups += 1u;
+    const uint32_t hash = string.hash();
+    size_t i = findSlot(string, hash);
+    if (i < CAPACITY && !_entries[i].empty()) {
+      _statistics.hits += 1u;
+      _statistics.bytesSaved += string.length();
+      return _entries[i];
+    }
+
+    if (i == CAPACITY && purge() == 0u) {
+      _statistics.rejections += 1u;
+      return string.materialize();
+    }
+
+    shared_str interned = string.materialize();
+    if (interned.empty()) {
+      // The allocator failed, there is nothing to intern
+      _statistics.rejections += 1u;
+      return interned;
+    }
+    insert(shared_str{interned});
+    return interned;
+  }
+
+  /**
+   * Check if a string with the same contents is interned.
+   */
+  bool contains(const strref& string) const {
+    size_t i = findSlot(string, string.hash());
+    return i < CAPACITY && !_entries[i].empty();
+  }
+
+  /**
+   * Remove all entries which are not used outside of the table anymore.
+   *
+   * Returns the number of removed entries.
+   */
+  size_t purge() {
+    size_t evicted = 0u;
+    for (size_t i = 0; i < CAPACITY;) {
+      if (!_entries[i].empty() && _entries[i].useCount() == 1u) {
+        // Check slot i again, as removing may move another entry into it
+        removeAt(i);
+        evicted += 1u;
+      } else {
+        i += 1u;
+      }
+    }
+    _statistics.evictions += evicted;
+    return evicted;
+  }
+
+  void clear() {
+    for (auto& entry : _entries) {
+      entry.clear();
+    }
+    _size = 0u;
+  }
+};
+
+}
+
+#endif
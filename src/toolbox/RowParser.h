@@ -0,0 +1,308 @@
+#ifndef TOOLBOX_ROWPARSER_H_
+#define TOOLBOX_ROWPARSER_H_
+
+#include "String.h"
+#include "Conversion.h"
+#include "Decimal.h"
+
+namespace toolbox {
+
+/**
+ * Outcome of parsing a single field of a row (see parseRow()).
+ */
+enum struct FieldError : uint8_t {
+  None,
+  /** The row has fewer fields. */
+  Missing,
+  /** The field is empty. */
+  Empty,
+  /** The field does not start with a valid value of the type (or it is out of range). */
+  Invalid,
+  /** The field starts with a valid value, but is followed by other characters. */
+  Trailing
+};
+
+struct FieldStatus final {
+  FieldError error;
+  /** Offset in the row where parsing of the field stopped. */
+  size_t position;
+};
+
+/**
+ * Parsers for the values of fields, reading a value from the start of a view.
+ *
+ * They return the number of characters consumed, or 0 if the view does not start with
+ * a valid value (leaving value unchanged). Integers are parsed in base 10, booleans as
+ * "1"/"0" or "true"/"false".
+ */
+template<typename T>
+struct field_parser final {
+  static_assert(std::is_integral<T>::value, "no field parser for this type");
+
+  /**
+   * Same syntax as parsing::parseInteger() in base 10, but with a single cursor over the
+   * field instead of trying 8 digits at once, which does not pay off for short fields.
+   */
+  static size_t parse(const basic_strref<RamTag>& string, T& value) {
+    using U = std::make_unsigned_t<T>;
+    const char* const begin = string.data();
+    const char* const end = begin + string.length();
+    const char* cursor = begin;
+    while (cursor != end && parsing::isSpace(*cursor)) {
+      ++cursor;
+    }
+    const bool negative = cursor != end && *cursor == '-';
+    if (cursor != end && (*cursor == '-' || *cursor == '+')) {
+      ++cursor;
+    }
+
+    constexpr U MAX_POSITIVE = U(std::numeric_limits<T>::max());
+    constexpr U MAX_NEGATIVE = std::is_signed<T>::value ? U(MAX_POSITIVE + 1u) : U(0);
+    const U limit = negative ? MAX_NEGATIVE : MAX_POSITIVE;
+
+    const char* const digits = cursor;
+    U result = 0;
+    if (std::is_signed<T>::value || !negative) {
+      // The first digits10 digits cannot overflow
+      const char* const safeEnd = cursor + min(size_t(end - cursor), size_t(std::numeric_limits<T>::digits10));
+      for (; cursor != safeEnd && uint8_t(*cursor - '0') <= 9u; ++cursor) {
+        result = result * 10u + uint8_t(*cursor - '0');
+      }
+    }
+    for (; cursor != end && uint8_t(*cursor - '0') <= 9u; ++cursor) {
+      const uint8_t digit = uint8_t(*cursor - '0');
+      if (digit > limit || result > U(limit - digit) / 10u) {
+        return 0;
+      }
+      result = result * 10u + digit;
+    }
+    if (cursor == digits) {
+      return 0;
+    }
+    value = static_cast<T>(negative ? U(U(0) - result) : result);
+    return cursor - begin;
+  }
+};
+
+template<>
+struct field_parser<bool> final {
+  static size_t parse(const basic_strref<RamTag>& string, bool& value) {
+    if (!string.empty() && (string.charAt(0) == '0' || string.charAt(0) == '1')) {
+      value = string.charAt(0) == '1';
+      return 1;
+    }
+    if (string.startsWith(basic_strref<RamTag>{"true", 4})) {
+      value = true;
+      return 4;
+    }
+    if (string.startsWith(basic_strref<RamTag>{"false", 5})) {
+      value = false;
+      return 5;
+    }
+    return 0;
+  }
+};
+
+template<>
+struct field_parser<float> final {
+  static size_t parse(const basic_strref<RamTag>& string, float& value) {
+    size_t position = 0;
+    const Maybe<float> parsed = parsing::parseFloatingPoint<float>(string, position);
+    if (!parsed.available()) {
+      return 0;
+    }
+    value = parsed.get();
+    return position;
+  }
+};
+
+template<>
+struct field_parser<double> final {
+  static size_t parse(const basic_strref<RamTag>& string, double& value) {
+    size_t position = 0;
+    const Maybe<double> parsed = parsing::parseFloatingPoint<double>(string, position);
+    if (!parsed.available()) {
+      return 0;
+    }
+    value = parsed.get();
+    return position;
+  }
+};
+
+template<>
+struct field_parser<Decimal> final {
+  static size_t parse(const basic_strref<RamTag>& string, Decimal& value) {
+    size_t position = 0;
+    const Maybe<Decimal> parsed = Decimal::parse(string, Decimal::AS_WRITTEN, position);
+    if (!parsed.available()) {
+      return 0;
+    }
+    value = parsed.get();
+    return position;
+  }
+};
+
+/**
+ * Size of the blocks of strings in PROGMEM which are copied to RAM for parsing a field,
+ * i.e. the maximum length of a field in PROGMEM (including leading and trailing spaces).
+ */
+constexpr size_t ROW_BLOCK_SIZE = 2u * PROGMEM_BLOCK_SIZE;
+
+namespace parsing {
+
+/**
+ * Length of the line terminator ("\n", "\r\n" or "\r" at the end) at offset of input, or
+ * 0 if there is none.
+ */
+template<typename Tag>
+size_t lineTerminatorLength(const basic_strref<Tag>& input, size_t offset) {
+  if (offset == input.length()) {
+    return 0u;
+  }
+  const char c = input.charAt(offset);
+  if (c == '\r') {
+    return offset + 1u == input.length() ? 1u : (input.charAt(offset + 1u) == '\n' ? 2u : 0u);
+  }
+  return c == '\n' ? 1u : 0u;
+}
+
+}
+
+/**
+ * Parse the first row of a typed view into values, see parseRow() for strrefs.
+ *
+ * The row is walked once with a single cursor: each field is parsed from a block of the
+ * view in RAM (the view itself if it is in RAM), followed by a check for the delimiter.
+ * Only errors and the end of the row need further checks. Sets next to the offset of the
+ * next row.
+ */
+template<typename T, typename Tag>
+size_t parseRow(const basic_strref<Tag>& input, char delimiter, T* values, size_t count, FieldStatus* status, size_t& next) {
+  const size_t length = input.length();
+  char buffer[Tag::BLOCK_SIZE == SIZE_MAX ? 1u : ROW_BLOCK_SIZE];
+  size_t blockStart = 0;
+  size_t blockLength = Tag::BLOCK_SIZE == SIZE_MAX ? length : min(length, sizeof(buffer));
+  const char* block = Tag::block(input.data(), blockLength, buffer);
+  const char* cursor = block;
+  size_t parsed = 0;
+  size_t field = 0;
+  for (; field < count; ++field) {
+    if (Tag::BLOCK_SIZE != SIZE_MAX) {
+      // Copy the next block, starting at the field
+      blockStart += cursor - block;
+      blockLength = min(length - blockStart, sizeof(buffer));
+      block = Tag::block(input.data() + blockStart, blockLength, buffer);
+      cursor = block;
+    }
+    const char* const blockEnd = block + blockLength;
+    const char* const start = cursor;
+
+    while (cursor != blockEnd && *cursor != delimiter && (*cursor == ' ' || *cursor == '\t')) {
+      ++cursor;
+    }
+    T value = values[field];
+    size_t consumed = 0;
+    if (cursor != blockEnd && *cursor != delimiter && !parsing::isSpace(*cursor)) {
+      consumed = field_parser<T>::parse(basic_strref<RamTag>{cursor, size_t(blockEnd - cursor)}, value);
+      cursor += consumed;
+    }
+    while (consumed > 0u && cursor != blockEnd && *cursor != delimiter && (*cursor == ' ' || *cursor == '\t')) {
+      ++cursor;
+    }
+    if (consumed > 0u && cursor != blockEnd && *cursor == delimiter) {
+      // Common case: a value followed by the delimiter
+      values[field] = value;
+      ++parsed;
+      if (status != nullptr) {
+        status[field] = {FieldError::None, blockStart + (cursor - block)};
+      }
+      ++cursor;
+      continue;
+    }
+
+    // Otherwise the field is invalid or the last one of the row
+    const size_t position = blockStart + (start - block);
+    size_t stop = consumed > 0u ? blockStart + (cursor - block) : position;
+    size_t terminator = parsing::lineTerminatorLength(input, stop);
+    bool rowEnd = stop == length || terminator > 0u;
+    FieldError error = FieldError::None;
+    if (consumed == 0u) {
+      error = rowEnd || input.charAt(stop) == delimiter ? FieldError::Empty : FieldError::Invalid;
+    } else if (cursor == blockEnd && blockStart + blockLength < length) {
+      // Longer than a block (only in PROGMEM)
+      error = FieldError::Invalid;
+    } else if (!rowEnd) {
+      error = FieldError::Trailing;
+    }
+    if (status != nullptr) {
+      status[field] = {error, stop};
+    }
+    if (error == FieldError::None) {
+      values[field] = value;
+      ++parsed;
+    }
+    while (!rowEnd && input.charAt(stop) != delimiter) {
+      ++stop;
+      terminator = parsing::lineTerminatorLength(input, stop);
+      rowEnd = stop == length || terminator > 0u;
+    }
+    if (rowEnd) {
+      next = stop + terminator;
+      for (++field; status != nullptr && field < count; ++field) {
+        status[field] = {FieldError::Missing, stop};
+      }
+      return parsed;
+    }
+    // Continue after the delimiter
+    if (Tag::BLOCK_SIZE == SIZE_MAX) {
+      cursor = block + stop + 1u;
+    } else {
+      blockStart = stop + 1u;
+      cursor = block;
+    }
+  }
+
+  // Skip any further fields
+  const ssize_t lineEnd = input.indexOf('\n', blockStart + (cursor - block));
+  next = lineEnd < 0 ? length : size_t(lineEnd) + 1u;
+  return parsed;
+}
+
+/**
+ * Parse the first row of input, consisting of fields separated by delimiter, into an
+ * array of values in a single pass and without copying or allocating.
+ *
+ * The row ends at a line terminator ("\n" or "\r\n") or the end of input. Values may be
+ * preceded by spaces or tabs. Parsing a field stops at the end of its value, which must
+ * only be followed by spaces or tabs up to the next delimiter. Invalid fields are
+ * skipped, leaving their values unchanged.
+ *
+ * If status is given, it receives the error and stop position of each of the count
+ * fields. If rest is given, it is set to the input after the line terminator, i.e. the
+ * next row.
+ *
+ * Returns the number of fields parsed successfully.
+ */
+template<typename T>
+size_t parseRow(const strref& input, char delimiter, T* values, size_t count, FieldStatus* status = nullptr, strref* rest = nullptr) {
+  size_t next = 0;
+  const size_t parsed = input.visit([=, &next] (auto view) { return parseRow(view, delimiter, values, count, status, next); });
+  if (rest != nullptr) {
+    *rest = input.skip(next);
+  }
+  return parsed;
+}
+
+/**
+ * Parse the first row of input into an array of values, see above.
+ *
+ * If status is given, it must have space for N elements.
+ */
+template<typename T, size_t N>
+size_t parseRow(const strref& input, char delimiter, T (&values)[N], FieldStatus* status = nullptr, strref* rest = nullptr) {
+  return parseRow(input, delimiter, values, N, status, rest);
+}
+
+}
+
+#endif
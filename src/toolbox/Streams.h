@@ -221,9 +221,13 @@ public:
         PGM_P p = reinterpret_cast<PGM_P>(string.fpstr());
         size_t length = string.length();
         size_t n = 0;
+        char block[PROGMEM_BLOCK_SIZE];
         while (n < length) {
-          if (write(pgm_read_byte(p++))) n++;
-          else break;
+          size_t blockSize = min(length - n, PROGMEM_BLOCK_SIZE);
+          memcpy_P(block, p + n, blockSize);
+          size_t written = _print.write(block, blockSize);
+          n += written;
+          if (written != blockSize) break;
         }
         return n;
       } else {
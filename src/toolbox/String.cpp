@@ -1,15 +1,313 @@
 #include "String.h"
 
+#ifndef ARDUINO_AVR_NANO
+#include <new>
+#else
+#include <new.h>
+#endif
+
 namespace toolbox {
 
+const char* memchr_W(const char* str, char c, size_t size)
+{
+#if defined(ARDUINO_ARCH_AVR)
+    return static_cast<const char*>(memchr(str, c, size));
+#else
+    // Check bytes until the pointer is aligned to allow reading whole words.
+    while (size > 0 && (reinterpret_cast<uintptr_t>(str) & (sizeof(uint32_t) - 1)) != 0)
+    {
+        if (*str == c)
+        {
+            return str;
+        }
+        ++str;
+        --size;
+    }
+
+    // A word contains c if XOR-ing it with c in every byte results in a zero byte.
+    const uint32_t pattern = 0x01010101u * static_cast<uint8_t>(c);
+    while (size >= sizeof(uint32_t))
+    {
+        uint32_t word;
+        memcpy(&word, str, sizeof(word));
+        word ^= pattern;
+        if (((word - 0x01010101u) & ~word & 0x80808080u) != 0)
+        {
+            break;
+        }
+        str += sizeof(uint32_t);
+        size -= sizeof(uint32_t);
+    }
+
+    while (size > 0)
+    {
+        if (*str == c)
+        {
+            return str;
+        }
+        ++str;
+        --size;
+    }
+
+    return nullptr;
+#endif
+}
+
+namespace {
+
+constexpr uint32_t ONES = 0x01010101u;
+constexpr uint32_t HIGH_BITS = 0x80808080u;
+
+/**
+ * Get 0x20 in each byte of the word which is an ASCII character in the range [first, last].
+ */
+inline uint32_t caseBitsInRange(uint32_t word, char first, char last) {
+    uint32_t heptets = word & ~HIGH_BITS;
+    uint32_t aboveFirst = heptets + ONES * uint32_t(0x80 - first);
+    uint32_t aboveLast = heptets + ONES * uint32_t(0x80 - last - 1);
+    return ((aboveFirst ^ aboveLast) & ~word & HIGH_BITS) >> 2;
+}
+
+inline uint32_t toLowerWord(uint32_t word) {
+    return word | caseBitsInRange(word, 'A', 'Z');
+}
+
+inline uint32_t toUpperWord(uint32_t word) {
+    return word & ~caseBitsInRange(word, 'a', 'z');
+}
+
+inline bool isContinuation(uint8_t c) {
+    return (c & 0xC0u) == 0x80u;
+}
+
+} // namespace
+
+int memcasecmp_W(const char* str1, const char* str2, size_t size)
+{
+    while (size >= sizeof(uint32_t))
+    {
+        uint32_t word1;
+        uint32_t word2;
+        memcpy(&word1, str1, sizeof(word1));
+        memcpy(&word2, str2, sizeof(word2));
+        if (toLowerWord(word1) != toLowerWord(word2))
+        {
+            break;
+        }
+        str1 += sizeof(uint32_t);
+        str2 += sizeof(uint32_t);
+        size -= sizeof(uint32_t);
+    }
+
+    while (size > 0)
+    {
+        int result = int(uint8_t(toLowerAscii(*str1))) - int(uint8_t(toLowerAscii(*str2)));
+        if (result != 0)
+        {
+            return result;
+        }
+        ++str1;
+        ++str2;
+        --size;
+    }
+
+    return 0;
+}
+
+void toLowerAscii_W(char* dest, const char* src, size_t size)
+{
+    while (size >= sizeof(uint32_t))
+    {
+        uint32_t word;
+        memcpy(&word, src, sizeof(word));
+        word = toLowerWord(word);
+        memcpy(dest, &word, sizeof(word));
+        src += sizeof(uint32_t);
+        dest += sizeof(uint32_t);
+        size -= sizeof(uint32_t);
+    }
+
+    while (size > 0)
+    {
+        *dest++ = toLowerAscii(*src++);
+        --size;
+    }
+}
+
+void toUpperAscii_W(char* dest, const char* src, size_t size)
+{
+    while (size >= sizeof(uint32_t))
+    {
+        uint32_t word;
+        memcpy(&word, src, sizeof(word));
+        word = toUpperWord(word);
+        memcpy(dest, &word, sizeof(word));
+        src += sizeof(uint32_t);
+        dest += sizeof(uint32_t);
+        size -= sizeof(uint32_t);
+    }
+
+    while (size > 0)
+    {
+        *dest++ = toUpperAscii(*src++);
+        --size;
+    }
+}
+
+size_t decodeUtf8(const char* str, size_t size, uint32_t& codePoint)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(str);
+    const uint8_t lead = bytes[0];
+    size_t length;
+    uint8_t lowest = 0x80u;
+    uint8_t highest = 0xBFu;
+
+    if (lead < 0x80u)
+    {
+        codePoint = lead;
+        return 1;
+    }
+    else if (lead < 0xC2u)
+    {
+        // Continuation byte or overlong 2 byte sequence
+        return 0;
+    }
+    else if (lead < 0xE0u)
+    {
+        length = 2;
+        codePoint = lead & 0x1Fu;
+    }
+    else if (lead < 0xF0u)
+    {
+        length = 3;
+        codePoint = lead & 0x0Fu;
+        if (lead == 0xE0u)
+        {
+            lowest = 0xA0u; // overlong
+        }
+        else if (lead == 0xEDu)
+        {
+            highest = 0x9Fu; // surrogates
+        }
+    }
+    else if (lead < 0xF5u)
+    {
+        length = 4;
+        codePoint = lead & 0x07u;
+        if (lead == 0xF0u)
+        {
+            lowest = 0x90u; // overlong
+        }
+        else if (lead == 0xF4u)
+        {
+            highest = 0x8Fu; // above U+10FFFF
+        }
+    }
+    else
+    {
+        return 0;
+    }
+
+    for (size_t i = 1; i < length; ++i)
+    {
+        if (i >= size)
+        {
+            return length;
+        }
+        const uint8_t c = bytes[i];
+        if (c < lowest || c > highest)
+        {
+            return 0;
+        }
+        lowest = 0x80u;
+        highest = 0xBFu;
+        codePoint = (codePoint << 6) | (c & 0x3Fu);
+    }
+    return length;
+}
+
+size_t validateUtf8_W(const char* str, size_t size, bool& valid)
+{
+    size_t position = 0;
+    while (position < size)
+    {
+        // Fast path for ASCII
+        while (size - position >= sizeof(uint32_t))
+        {
+            uint32_t word;
+            memcpy(&word, str + position, sizeof(word));
+            if ((word & HIGH_BITS) != 0)
+            {
+                break;
+            }
+            position += sizeof(uint32_t);
+        }
+        while (position < size && uint8_t(str[position]) < 0x80u)
+        {
+            ++position;
+        }
+        if (position == size)
+        {
+            break;
+        }
+
+        uint32_t codePoint;
+        size_t length = decodeUtf8(str + position, size - position, codePoint);
+        if (length == 0)
+        {
+            valid = false;
+            return position;
+        }
+        if (length > size - position)
+        {
+            // Truncated, the caller may continue with more data
+            break;
+        }
+        position += length;
+    }
+
+    valid = true;
+    return position;
+}
+
+size_t countCodePoints_W(const char* str, size_t size)
+{
+    size_t count = 0;
+    const char* end = str + size;
+    while (end - str >= static_cast<ptrdiff_t>(sizeof(uint32_t)))
+    {
+        // Count in every byte of a word, up to 255 words before summing up the bytes.
+        uint32_t counts = 0;
+        for (size_t i = 0; i < UINT8_MAX && end - str >= static_cast<ptrdiff_t>(sizeof(uint32_t)); ++i)
+        {
+            uint32_t word;
+            memcpy(&word, str, sizeof(word));
+            // All bytes except continuation bytes (highest bit set, second highest bit cleared)
+            counts += ((~word >> 7) | (word >> 6)) & ONES;
+            str += sizeof(uint32_t);
+        }
+        counts = (counts & 0x00FF00FFu) + ((counts >> 8) & 0x00FF00FFu);
+        count += (counts + (counts >> 16)) & 0xFFFFu;
+    }
+    while (str < end)
+    {
+        count += !isContinuation(*str++);
+    }
+    return count;
+}
+
+#if defined(ARDUINO_ARCH_AVR)
+// Reading PROGMEM is cheap on AVR and its *_P functions are already optimized,
+// so there is no benefit in reading blocks into RAM first.
+
 int memcmp_P2(PGM_P str1P, PGM_P str2P, size_t size)
 {
     int result = 0;
 
     while (size > 0)
     {
-        char ch1 = pgm_read_byte(str1P++);
-        char ch2 = pgm_read_byte(str2P++);
+        uint8_t ch1 = pgm_read_byte(str1P++);
+        uint8_t ch2 = pgm_read_byte(str2P++);
         result = ch1 - ch2;
         if (result != 0)
         {
@@ -22,9 +320,119 @@ int memcmp_P2(PGM_P str1P, PGM_P str2P, size_t size)
     return result;
 }
 
-shared_str::shared_str(const strref& string) {
-    _storage = new storage(string.length());
-    string.copy(_storage->buffer, _storage->length + 1, true);
+int memcmp_PB(const char* str1, PGM_P str2P, size_t size)
+{
+    return memcmp_P(str1, str2P, size);
+}
+
+PGM_P memchr_PB(PGM_P strP, char c, size_t size)
+{
+    return static_cast<PGM_P>(memchr_P(strP, c, size));
+}
+
+#else
+// memcpy_P reads whole aligned words from flash, so copying blocks into a stack
+// buffer and working on that is much cheaper than individual pgm_read_byte calls.
+
+int memcmp_P2(PGM_P str1P, PGM_P str2P, size_t size)
+{
+    char block1[PROGMEM_BLOCK_SIZE];
+    char block2[PROGMEM_BLOCK_SIZE];
+
+    while (size > 0)
+    {
+        size_t blockSize = min(size, PROGMEM_BLOCK_SIZE);
+        memcpy_P(block1, str1P, blockSize);
+        memcpy_P(block2, str2P, blockSize);
+        int result = memcmp(block1, block2, blockSize);
+        if (result != 0)
+        {
+            return result;
+        }
+
+        str1P += blockSize;
+        str2P += blockSize;
+        size -= blockSize;
+    }
+
+    return 0;
+}
+
+int memcmp_PB(const char* str1, PGM_P str2P, size_t size)
+{
+    char block[PROGMEM_BLOCK_SIZE];
+
+    while (size > 0)
+    {
+        size_t blockSize = min(size, PROGMEM_BLOCK_SIZE);
+        memcpy_P(block, str2P, blockSize);
+        int result = memcmp(str1, block, blockSize);
+        if (result != 0)
+        {
+            return result;
+        }
+
+        str1 += blockSize;
+        str2P += blockSize;
+        size -= blockSize;
+    }
+
+    return 0;
+}
+
+PGM_P memchr_PB(PGM_P strP, char c, size_t size)
+{
+    char block[PROGMEM_BLOCK_SIZE];
+
+    while (size > 0)
+    {
+        size_t blockSize = min(size, PROGMEM_BLOCK_SIZE);
+        memcpy_P(block, strP, blockSize);
+        const char* p = memchr_W(block, c, blockSize);
+        if (p != nullptr)
+        {
+            return strP + (p - block);
+        }
+
+        strP += blockSize;
+        size -= blockSize;
+    }
+
+    return nullptr;
+}
+
+#endif
+
+size_t shared_str::storage::blockSize(size_t length) {
+    size_t capacity = length > SHORT_CAPACITY ? length : SHORT_CAPACITY;
+    return sizeof(storage) + capacity + 1;
+}
+
+shared_str::storage* shared_str::storage::create(size_t length, IAllocator& allocator) {
+    void* memory = allocator.allocate(blockSize(length));
+    if (memory == nullptr) {
+        return nullptr;
+    }
+    // Construct the header (including the atomic members with TOOLBOX_ATOMIC_REFCOUNT)
+    storage* block = new (memory) storage{1u, 0u, length, &allocator};
+    block->buffer()[length] = '\0';
+    return block;
+}
+
+void shared_str::storage::destroy() {
+    IAllocator* blockAllocator = allocator;
+    const size_t size = blockSize(length);
+    this->~storage();
+    blockAllocator->deallocate(this, size);
+}
+
+shared_str::shared_str(const strref& string) : shared_str(string, defaultAllocator()) {}
+
+shared_str::shared_str(const strref& string, IAllocator& allocator) {
+    _storage = storage::create(string.length(), allocator);
+    if (_storage != nullptr) {
+        string.copy(_storage->buffer(), _storage->length + 1, true);
+    }
 }
 
 const strref strref::EMPTY {};
@@ -13,19 +13,524 @@ using std::min;
 #else
 using ssize_t = long;
 #endif
+#ifdef TOOLBOX_ATOMIC_REFCOUNT
+#include <atomic>
+#endif
 #include "Maybe.h"
+#include "Hash.h"
+#include "Allocator.h"
 
 namespace toolbox {
 
 inline const char EMPTY_CSTR[] = "";
 inline const char EMPTY_FPSTR[] PROGMEM = "";
 
+/**
+ * Size of the stack buffers used to read PROGMEM strings in blocks instead of
+ * reading them byte by byte.
+ */
+constexpr size_t PROGMEM_BLOCK_SIZE = 32u;
+
 /**
  * Compare two PROGMEM strings by content.
  */
 int memcmp_P2(PGM_P str1P, PGM_P str2P, size_t size);
 
+/**
+ * Compare a string in RAM with a PROGMEM string by content, reading the latter in blocks.
+ */
+int memcmp_PB(const char* str1, PGM_P str2P, size_t size);
+
+/**
+ * Find a character in a PROGMEM string, reading it in blocks.
+ */
+PGM_P memchr_PB(PGM_P strP, char c, size_t size);
+
+/**
+ * Find a character in a string in RAM, scanning a whole word at a time.
+ */
+const char* memchr_W(const char* str, char c, size_t size);
+
+/**
+ * Convert an ASCII character to lower case.
+ */
+constexpr char toLowerAscii(char c) {
+  return c >= 'A' && c <= 'Z' ? char(c + ('a' - 'A')) : c;
+}
+
+/**
+ * Convert an ASCII character to upper case.
+ */
+constexpr char toUpperAscii(char c) {
+  return c >= 'a' && c <= 'z' ? char(c - ('a' - 'A')) : c;
+}
+
+/**
+ * Compare two strings in RAM ignoring the case of ASCII letters, a whole word at a time.
+ */
+int memcasecmp_W(const char* str1, const char* str2, size_t size);
+
+/**
+ * Convert ASCII letters to lower case, a whole word at a time (dest may be the same as src).
+ */
+void toLowerAscii_W(char* dest, const char* src, size_t size);
+
+/**
+ * Convert ASCII letters to upper case, a whole word at a time (dest may be the same as src).
+ */
+void toUpperAscii_W(char* dest, const char* src, size_t size);
+
+/**
+ * Replacement for invalid UTF-8 sequences when decoding code points.
+ */
+constexpr uint32_t REPLACEMENT_CODE_POINT = 0xFFFDu;
+
+/**
+ * Decode the UTF-8 sequence at the start of str.
+ *
+ * Returns the length of the sequence, which is greater than size if the sequence is
+ * truncated, or 0 if it is invalid (overlong, surrogate, above U+10FFFF, ...).
+ */
+size_t decodeUtf8(const char* str, size_t size, uint32_t& codePoint);
+
+/**
+ * Validate UTF-8 in RAM, skipping ASCII a whole word at a time.
+ *
+ * Returns the length of the valid prefix, which ends either at an invalid sequence
+ * (valid is set to false) or at a sequence truncated by the end of str.
+ */
+size_t validateUtf8_W(const char* str, size_t size, bool& valid);
+
+/**
+ * Count the UTF-8 code points in RAM (all bytes except continuation bytes), a whole word
+ * at a time.
+ */
+size_t countCodePoints_W(const char* str, size_t size);
+
 class strref;
+class split_range;
+class codepoint_range;
+
+/**
+ * Storage tag for strings in normal memory (RAM).
+ */
+struct RamTag final {
+  static size_t length(const char* str) { return strlen(str); }
+  static char read(const char* str) { return *str; }
+  static void copy(char* dest, const char* src, size_t length) { memcpy(dest, src, length); }
+  static const char* find(const char* str, char c, size_t length) { return memchr_W(str, c, length); }
+  static constexpr uint32_t hash(const char* str, size_t length) { return hash32(str, length); }
+  static const char* block(const char* str, size_t, char*) { return str; }
+  static constexpr size_t BLOCK_SIZE = SIZE_MAX;
+};
+
+/**
+ * Storage tag for strings in PROGMEM.
+ */
+struct ProgmemTag final {
+  static size_t length(const char* str) { return strlen_P(str); }
+  static char read(const char* str) { return pgm_read_byte(str); }
+  static void copy(char* dest, const char* src, size_t length) { memcpy_P(dest, src, length); }
+  static const char* find(const char* str, char c, size_t length) { return memchr_PB(str, c, length); }
+  static uint32_t hash(const char* str, size_t length) { return hash32_P(str, length); }
+  static const char* block(const char* str, size_t length, char* buffer) { memcpy_P(buffer, str, length); return buffer; }
+  static constexpr size_t BLOCK_SIZE = PROGMEM_BLOCK_SIZE;
+};
+
+/**
+ * Compare string contents from (possibly) different kinds of memory.
+ */
+template<typename TagA, typename TagB>
+struct memory_compare;
+
+template<>
+struct memory_compare<RamTag, RamTag> final {
+  static int compare(const char* a, const char* b, size_t size) { return memcmp(a, b, size); }
+};
+
+template<>
+struct memory_compare<RamTag, ProgmemTag> final {
+  static int compare(const char* a, const char* b, size_t size) { return memcmp_PB(a, b, size); }
+};
+
+template<>
+struct memory_compare<ProgmemTag, RamTag> final {
+  static int compare(const char* a, const char* b, size_t size) { return -memcmp_PB(b, a, size); }
+};
+
+template<>
+struct memory_compare<ProgmemTag, ProgmemTag> final {
+  static int compare(const char* a, const char* b, size_t size) { return memcmp_P2(a, b, size); }
+};
+
+/**
+ * Compare string contents from (possibly) different kinds of memory, ignoring the case
+ * of ASCII letters.
+ *
+ * Strings in PROGMEM are read in blocks of up to PROGMEM_BLOCK_SIZE characters.
+ */
+template<typename TagA, typename TagB>
+int memcasecmp(const char* a, const char* b, size_t size) {
+  char bufferA[PROGMEM_BLOCK_SIZE];
+  char bufferB[PROGMEM_BLOCK_SIZE];
+  while (size > 0u) {
+    size_t blockSize = min(size, PROGMEM_BLOCK_SIZE);
+    int result = memcasecmp_W(TagA::block(a, blockSize, bufferA), TagB::block(b, blockSize, bufferB), blockSize);
+    if (result != 0) {
+      return result;
+    }
+    a += blockSize;
+    b += blockSize;
+    size -= blockSize;
+  }
+  return 0;
+}
+
+/**
+ * Lightweight, read-only string view where the kind of memory is known at compile time.
+ *
+ * In contrast to strref, all accessors are resolved statically without switching on the
+ * type of the referenced string, which makes it suitable for tight loops (e.g. parsing).
+ * It converts implicitly to strref, so it can be passed to any API expecting a strref.
+ *
+ * Use strref::visit() to get a typed view of an existing strref.
+ *
+ * NOTE: this is a non-owning view, i.e. the referenced string must stay valid while the
+ * view is used. This also applies to views of strrefs referencing a shared_str.
+ */
+template<typename Tag>
+class basic_strref final {
+  const char* _data;
+  size_t _length;
+  bool _zeroTerminated;
+
+public:
+  constexpr basic_strref() : _data(EMPTY_CSTR), _length(0), _zeroTerminated(true) {}
+  explicit basic_strref(const char* data) : _data(data), _length(Tag::length(data)), _zeroTerminated(true) {}
+  constexpr basic_strref(const char* data, size_t length, bool zeroTerminated = false) : _data(data), _length(length), _zeroTerminated(zeroTerminated) {}
+
+  constexpr const char* data() const {
+    return _data;
+  }
+
+  constexpr size_t length() const {
+    return _length;
+  }
+
+  constexpr bool empty() const {
+    return _length == 0u;
+  }
+
+  constexpr bool isZeroTerminated() const {
+    return _zeroTerminated;
+  }
+
+  char charAt(size_t i) const {
+    return Tag::read(_data + i);
+  }
+
+  /**
+   * Hash of the contents (see hash32()), which is the same for all kinds of memory.
+   */
+  constexpr uint32_t hash() const {
+    return Tag::hash(_data, _length);
+  }
+
+  size_t copy(char* dest, size_t destSize, bool zeroTerminated) const {
+    if (destSize == 0) {
+      return 0;
+    }
+    size_t lengthToCopy = min(destSize - (zeroTerminated ? 1 : 0), _length);
+    Tag::copy(dest, _data, lengthToCopy);
+    if (zeroTerminated) {
+      dest[lengthToCopy] = '\0';
+    }
+    return lengthToCopy;
+  }
+
+  ssize_t indexOf(char c, size_t from = 0) const {
+    if (from >= _length) {
+      return -1;
+    }
+    const char* p = Tag::find(_data + from, c, _length - from);
+    return p ? p - _data : -1;
+  }
+
+  /**
+   * Find the first occurrence of the given string at or after from, using the
+   * Boyer-Moore-Horspool algorithm for needles longer than one character.
+   */
+  template<typename OtherTag>
+  ssize_t find(const basic_strref<OtherTag>& needle, size_t from = 0) const {
+    const size_t m = needle.length();
+    if (from > _length || m > _length - from) {
+      return -1;
+    }
+    if (m == 0) {
+      return from;
+    }
+    if (m == 1) {
+      return indexOf(needle.charAt(0), from);
+    }
+
+    uint8_t shift[256];
+    memset(shift, min(m, size_t(UINT8_MAX)), sizeof(shift));
+    for (size_t i = 0; i < m - 1; ++i) {
+      shift[uint8_t(needle.charAt(i))] = min(m - 1 - i, size_t(UINT8_MAX));
+    }
+
+    const char last = needle.charAt(m - 1);
+    for (size_t pos = from; pos <= _length - m;) {
+      const char c = charAt(pos + m - 1);
+      if (c == last && memory_compare<Tag, OtherTag>::compare(_data + pos, needle.data(), m - 1) == 0) {
+        return pos;
+      }
+      pos += shift[uint8_t(c)];
+    }
+    return -1;
+  }
+
+  /**
+   * Find the last occurrence of the given string, using the Boyer-Moore-Horspool
+   * algorithm (scanning backwards) for needles longer than one character.
+   */
+  template<typename OtherTag>
+  ssize_t rfind(const basic_strref<OtherTag>& needle) const {
+    const size_t m = needle.length();
+    if (m > _length) {
+      return -1;
+    }
+    if (m == 0) {
+      return _length;
+    }
+
+    uint8_t shift[256];
+    memset(shift, min(m, size_t(UINT8_MAX)), sizeof(shift));
+    for (size_t i = m - 1; i > 0; --i) {
+      shift[uint8_t(needle.charAt(i))] = min(i, size_t(UINT8_MAX));
+    }
+
+    const char first = needle.charAt(0);
+    size_t pos = _length - m;
+    while (true) {
+      const char c = charAt(pos);
+      if (c == first && memory_compare<Tag, OtherTag>::compare(_data + pos + 1, needle.data() + 1, m - 1) == 0) {
+        return pos;
+      }
+      if (shift[uint8_t(c)] > pos) {
+        return -1;
+      }
+      pos -= shift[uint8_t(c)];
+    }
+  }
+
+  /**
+   * Find the first character which is contained in the given set of characters.
+   */
+  template<typename OtherTag>
+  ssize_t findFirstOf(const basic_strref<OtherTag>& set, size_t from = 0) const {
+    if (set.length() == 1) {
+      return indexOf(set.charAt(0), from);
+    }
+
+    uint8_t bitmap[32] {};
+    for (size_t i = 0; i < set.length(); ++i) {
+      const uint8_t c = set.charAt(i);
+      bitmap[c >> 3] |= uint8_t(1u << (c & 7u));
+    }
+
+    for (size_t i = from; i < _length; ++i) {
+      const uint8_t c = charAt(i);
+      if (bitmap[c >> 3] & (1u << (c & 7u))) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  basic_strref substring(size_t offset, size_t length) const {
+    offset = min(offset, _length);
+    length = min(length, _length - offset);
+    return {_data + offset, length, offset + length == _length ? _zeroTerminated : false};
+  }
+
+  basic_strref leftmost(size_t length) const {
+    return substring(0, length);
+  }
+
+  basic_strref rightmost(size_t length) const {
+    return substring(length < _length ? _length - length : 0, length);
+  }
+
+  basic_strref skip(size_t offset) const {
+    return substring(offset, _length);
+  }
+
+  basic_strref ltrim(char c) const {
+    size_t offset = 0;
+    while (offset < _length && charAt(offset) == c) {
+      offset++;
+    }
+    return skip(offset);
+  }
+
+  template<typename OtherTag>
+  int compare(const basic_strref<OtherTag>& other) const {
+    if (_length != other.length()) {
+      return _length < other.length() ? -1 : 1;
+    }
+    return memory_compare<Tag, OtherTag>::compare(_data, other.data(), _length);
+  }
+
+  template<typename OtherTag>
+  bool startsWith(const basic_strref<OtherTag>& prefix) const {
+    return prefix.length() <= _length && leftmost(prefix.length()).compare(prefix) == 0;
+  }
+
+  template<typename OtherTag>
+  bool endsWith(const basic_strref<OtherTag>& suffix) const {
+    return suffix.length() <= _length && rightmost(suffix.length()).compare(suffix) == 0;
+  }
+
+  template<typename OtherTag>
+  int compareIgnoreCase(const basic_strref<OtherTag>& other) const {
+    if (_length != other.length()) {
+      return _length < other.length() ? -1 : 1;
+    }
+    return memcasecmp<Tag, OtherTag>(_data, other.data(), _length);
+  }
+
+  template<typename OtherTag>
+  bool equalsIgnoreCase(const basic_strref<OtherTag>& other) const {
+    return _length == other.length() && memcasecmp<Tag, OtherTag>(_data, other.data(), _length) == 0;
+  }
+
+  /**
+   * Find the first occurrence of the given string at or after from, ignoring the case
+   * of ASCII letters (using the Boyer-Moore-Horspool algorithm on case-folded characters).
+   */
+  template<typename OtherTag>
+  ssize_t findIgnoreCase(const basic_strref<OtherTag>& needle, size_t from = 0) const {
+    const size_t m = needle.length();
+    if (from > _length || m > _length - from) {
+      return -1;
+    }
+    if (m == 0) {
+      return from;
+    }
+
+    uint8_t shift[256];
+    memset(shift, min(m, size_t(UINT8_MAX)), sizeof(shift));
+    for (size_t i = 0; i < m - 1; ++i) {
+      shift[uint8_t(toLowerAscii(needle.charAt(i)))] = min(m - 1 - i, size_t(UINT8_MAX));
+    }
+
+    const char last = toLowerAscii(needle.charAt(m - 1));
+    for (size_t pos = from; pos <= _length - m;) {
+      const char c = toLowerAscii(charAt(pos + m - 1));
+      if (c == last && memcasecmp<Tag, OtherTag>(_data + pos, needle.data(), m - 1) == 0) {
+        return pos;
+      }
+      pos += shift[uint8_t(c)];
+    }
+    return -1;
+  }
+
+  /**
+   * Copy the string into dest, converting ASCII letters to lower case.
+   */
+  size_t toLower(char* dest, size_t destSize, bool zeroTerminated) const {
+    size_t length = copy(dest, destSize, zeroTerminated);
+    toLowerAscii_W(dest, dest, length);
+    return length;
+  }
+
+  /**
+   * Copy the string into dest, converting ASCII letters to upper case.
+   */
+  size_t toUpper(char* dest, size_t destSize, bool zeroTerminated) const {
+    size_t length = copy(dest, destSize, zeroTerminated);
+    toUpperAscii_W(dest, dest, length);
+    return length;
+  }
+
+  /**
+   * Check whether the string is valid UTF-8.
+   */
+  bool isValidUtf8() const {
+    char buffer[PROGMEM_BLOCK_SIZE];
+    size_t position = 0;
+    while (position < _length) {
+      size_t blockSize = min(_length - position, Tag::BLOCK_SIZE);
+      bool valid;
+      size_t validLength = validateUtf8_W(Tag::block(_data + position, blockSize, buffer), blockSize, valid);
+      if (!valid || validLength == 0) {
+        // An invalid sequence, or a sequence truncated by the end of the string
+        return false;
+      }
+      // Continue at a sequence truncated by the end of the block
+      position += validLength;
+    }
+    return true;
+  }
+
+  /**
+   * Count the code points of the UTF-8 encoded string.
+   *
+   * For invalid UTF-8 this is only an estimate, as continuation bytes are not counted.
+   */
+  size_t countCodePoints() const {
+    char buffer[PROGMEM_BLOCK_SIZE];
+    size_t count = 0;
+    for (size_t position = 0; position < _length;) {
+      size_t blockSize = min(_length - position, Tag::BLOCK_SIZE);
+      count += countCodePoints_W(Tag::block(_data + position, blockSize, buffer), blockSize);
+      position += blockSize;
+    }
+    return count;
+  }
+
+  template<typename OtherTag>
+  bool operator==(const basic_strref<OtherTag>& other) const {
+    return compare(other) == 0;
+  }
+
+  template<typename OtherTag>
+  bool operator!=(const basic_strref<OtherTag>& other) const {
+    return compare(other) != 0;
+  }
+
+  operator strref() const;
+};
+
+/**
+ * Typed view of a string in RAM.
+ */
+using ram_strref = basic_strref<RamTag>;
+
+/**
+ * Typed view of a string in PROGMEM.
+ */
+using progmem_strref = basic_strref<ProgmemTag>;
+
+inline namespace literals {
+
+/**
+ * String literal in RAM with its length determined at compile time, e.g. "topic"_sr.
+ */
+constexpr ram_strref operator""_sr(const char* str, size_t length) {
+  return {str, length, true};
+}
+
+}
+
+/**
+ * String literal placed in PROGMEM with its length determined at compile time.
+ *
+ * The result converts to strref without scanning the string, in contrast to
+ * constructing a strref from F("...") which has to call strlen_P.
+ */
+#define TOOLBOX_FSTR(literal) (::toolbox::progmem_strref{PSTR(literal), sizeof(literal) - 1u, true})
 
 /**
  * Reference-counted shared string storage.
@@ -33,27 +538,78 @@ class strref;
  * This class provides an immutable string storage with reference counting
  * to allow efficient sharing of string data without unnecessary copies. It still
  * allocates memory on the heap, so it can lead to fragmentation if used heavily.
+ *
+ * The reference counter, length and characters are kept in a single heap block.
+ * Short strings (up to SHORT_CAPACITY characters) always use a block of the same
+ * size, so that blocks freed by one short string can be reused by any other.
+ *
+ * Blocks are allocated from the default allocator (see setDefaultAllocator()) or an
+ * explicitly given allocator. If the allocation fails, the shared_str is empty.
+ *
+ * The reference counter is not synchronized by default, so instances sharing the same
+ * storage must only be used by a single thread. Define TOOLBOX_ATOMIC_REFCOUNT to use
+ * an atomic (and 32 bit wide) reference counter, which allows sharing strings between
+ * threads or cores.
  */
 class shared_str final {
+public:
+  static constexpr size_t SHORT_CAPACITY = 15u;
+
+private:
   struct storage final {
+#ifdef TOOLBOX_ATOMIC_REFCOUNT
+    std::atomic<uint32_t> refCounter;
+    std::atomic<uint32_t> hashValue; // 0 until computed
+#else
     uint16_t refCounter;
-    char* buffer;
+    uint32_t hashValue; // 0 until computed
+#endif
     size_t length;
+    IAllocator* allocator;
+
+    static size_t blockSize(size_t length);
+    static storage* create(size_t length, IAllocator& allocator);
+    void destroy();
+
+    char* buffer() { return reinterpret_cast<char*>(this + 1); }
 
-    storage(size_t len) : refCounter(1), length(len) {
-      buffer = new char[len + 1];
-      buffer[len] = '\0';
+#ifdef TOOLBOX_ATOMIC_REFCOUNT
+    uint32_t hash() {
+      uint32_t value = hashValue.load(std::memory_order_relaxed);
+      if (value == 0u) {
+        value = hash32(buffer(), length);
+        hashValue.store(value, std::memory_order_relaxed);
+      }
+      return value;
     }
-    ~storage() {
-      delete[] buffer;
+
+    size_t useCount() const { return refCounter.load(std::memory_order_relaxed); }
+    void add_shared() { refCounter.fetch_add(1u, std::memory_order_relaxed); }
+    void release_shared() { if (refCounter.fetch_sub(1u, std::memory_order_acq_rel) == 1u) { destroy(); } }
+#else
+    uint32_t hash() {
+      if (hashValue == 0u) {
+        hashValue = hash32(buffer(), length);
+      }
+      return hashValue;
     }
 
+    size_t useCount() const { return refCounter; }
     void add_shared() { ++refCounter; }
-    void release_shared() { if (--refCounter == 0) { delete this; } }
+    void release_shared() { if (--refCounter == 0) { destroy(); } }
+#endif
   };
 
   storage* _storage;
 
+  explicit shared_str(storage* storage) : _storage(storage) {
+    if (_storage != nullptr) {
+      _storage->add_shared();
+    }
+  }
+
+  friend class strref;
+
 public:
   shared_str() : _storage(nullptr) {}
   ~shared_str() {
@@ -63,6 +619,23 @@ public:
   }
 
   explicit shared_str(const strref& string);
+  shared_str(const strref& string, IAllocator& allocator);
+
+  /**
+   * Create a string of the given length, whose characters are written by calling
+   * fill(char* buffer, size_t length).
+   */
+  template<typename F>
+  static shared_str build(size_t length, F fill, IAllocator& allocator = defaultAllocator()) {
+    shared_str string;
+    if (length > 0u) {
+      string._storage = storage::create(length, allocator);
+      if (string._storage != nullptr) {
+        fill(string._storage->buffer(), length);
+      }
+    }
+    return string;
+  }
 
   shared_str(const shared_str& other) : _storage(other._storage) {
     if (_storage != nullptr) {
@@ -107,7 +680,30 @@ public:
   }
 
   const char* cstr() const {
-    return _storage != nullptr ? _storage->buffer : EMPTY_CSTR;
+    return _storage != nullptr ? _storage->buffer() : EMPTY_CSTR;
+  }
+
+  /**
+   * Number of shared_str instances and strref instances sharing the same storage.
+   */
+  size_t useCount() const {
+    return _storage != nullptr ? _storage->useCount() : 0u;
+  }
+
+  /**
+   * Check if this and the other instance share the same storage, i.e. this is
+   * a pointer comparison and not a comparison of the contents.
+   */
+  bool sharesStorageWith(const shared_str& other) const {
+    return _storage == other._storage;
+  }
+
+  /**
+   * Hash of the contents (see hash32()). It is computed once and then cached in
+   * the shared storage, so all copies benefit from it.
+   */
+  uint32_t hash() const {
+    return _storage != nullptr ? _storage->hash() : hash32(EMPTY_CSTR, 0);
   }
 
   void clear() {
@@ -144,12 +740,12 @@ private:
     const String* string;
     const char* constchar;
     const __FlashStringHelper* progmem;
-    shared_str* sharedstr;
+    shared_str::storage* sharedstr;
     Ref() {}
     Ref(const String* string) : string(string) {}
     Ref(const char* constchar) : constchar(constchar) {}
     Ref(const __FlashStringHelper* progmem) : progmem(progmem) {}
-    Ref(shared_str* sharedstr) : sharedstr(sharedstr) {}
+    Ref(shared_str::storage* sharedstr) : sharedstr(sharedstr) {}
   };
 
   Type _type;
@@ -160,15 +756,27 @@ private:
 
   strref(Type type, Ref reference, size_t offset, size_t length, bool zeroTerminated) : _type(type), _reference(reference), _offset(offset), _length(length), _zeroTerminated(zeroTerminated) {
     if (_type == Type::SharedStr) {
-      _reference.sharedstr = new shared_str(*reference.sharedstr);
+      _reference.sharedstr->add_shared();
     }
   }
 
+  /**
+   * Reference the storage of a shared_str directly, so that copies and slices only
+   * need to bump the intrusive reference counter instead of allocating anything.
+   * Empty shared_str instances (without storage) are referenced as an empty C-string.
+   */
+  strref(shared_str::storage* storage, size_t length, bool zeroTerminated)
+    : strref(storage != nullptr ? Type::SharedStr : Type::ConstChar,
+             storage != nullptr ? Ref(storage) : Ref(EMPTY_CSTR),
+             0,
+             storage != nullptr ? min(length, storage->length) : 0,
+             storage != nullptr ? zeroTerminated : true) {}
+
 public:
   strref() : strref(EMPTY_CSTR, 0, true) {}
   strref(const strref& other) : _type(other._type), _reference(other._reference), _offset(other._offset), _length(other._length), _zeroTerminated(other._zeroTerminated) {
     if (_type == Type::SharedStr) {
-      _reference.sharedstr = new shared_str(*other._reference.sharedstr);
+      _reference.sharedstr->add_shared();
     }
   }
   strref(strref&& other) : _type(other._type), _reference(other._reference), _offset(other._offset), _length(other._length), _zeroTerminated(other._zeroTerminated) {
@@ -180,24 +788,24 @@ public:
   }
   strref& operator=(const strref& other) {
     if (this != &other) {
+      if (other._type == Type::SharedStr) {
+        other._reference.sharedstr->add_shared();
+      }
       if (_type == Type::SharedStr) {
-        delete _reference.sharedstr;
+        _reference.sharedstr->release_shared();
       }
       _type = other._type;
       _reference = other._reference;
       _offset = other._offset;
       _length = other._length;
       _zeroTerminated = other._zeroTerminated;
-      if (_type == Type::SharedStr) {
-        _reference.sharedstr = new shared_str(*other._reference.sharedstr);
-      }
     }
     return *this;
   }
   strref& operator=(strref&& other) {
     if (this != &other) {
       if (_type == Type::SharedStr) {
-        delete _reference.sharedstr;
+        _reference.sharedstr->release_shared();
       }
       _type = other._type;
       _reference = other._reference;
@@ -215,7 +823,7 @@ public:
   }
   ~strref() {
     if (_type == Type::SharedStr) {
-      delete _reference.sharedstr;
+      _reference.sharedstr->release_shared();
     }
   }
   
@@ -228,8 +836,8 @@ public:
   strref(const __FlashStringHelper* string) : _type(Type::ProgMem), _reference(string), _offset(0), _length(strlen_P(reinterpret_cast<const char*>(string))), _zeroTerminated(true) {}
   strref(const __FlashStringHelper* string, size_t length, bool zeroTerminated=false) : _type(Type::ProgMem), _reference(string), _offset(0), _length(length), _zeroTerminated(zeroTerminated) {} 
 
-  strref(const shared_str& string) : _type(Type::SharedStr), _reference(new shared_str(string)), _offset(0), _length(string.length()), _zeroTerminated(true) {}
-  strref(const shared_str& string, size_t length) : _type(Type::SharedStr), _reference(new shared_str(string)), _offset(0), _length(length), _zeroTerminated(false) {}
+  strref(const shared_str& string) : strref(string._storage, string.length(), true) {}
+  strref(const shared_str& string, size_t length) : strref(string._storage, length, false) {}
 
   Type type() const {
     return _type;
@@ -264,7 +872,7 @@ public:
       case Type::String: return _reference.string->c_str();
       case Type::ConstChar: return _reference.constchar;
       case Type::ProgMem: return reinterpret_cast<const char*>(_reference.progmem);
-      case Type::SharedStr: return _reference.sharedstr->cstr();
+      case Type::SharedStr: return _reference.sharedstr->buffer();
       default: return EMPTY_CSTR;
     }
   }
@@ -274,11 +882,27 @@ public:
       case Type::String: return _reference.string->c_str() + _offset;
       case Type::ConstChar: return _reference.constchar + _offset;
       case Type::ProgMem: return reinterpret_cast<const char*>(_reference.progmem) + _offset;
-      case Type::SharedStr: return _reference.sharedstr->cstr() + _offset;
+      case Type::SharedStr: return _reference.sharedstr->buffer() + _offset;
       default: return EMPTY_CSTR;
     }
   }
 
+  /**
+   * Call the given function with a typed view (ram_strref or progmem_strref) of this
+   * string, so that the type of the referenced string is only selected once instead
+   * of on each access.
+   *
+   * The view is only valid during the call.
+   */
+  template<typename F>
+  auto visit(F f) const {
+    if (_type == Type::ProgMem) {
+      return f(progmem_strref{cstr(), _length, _zeroTerminated});
+    } else {
+      return f(ram_strref{cstr(), _length, _zeroTerminated});
+    }
+  }
+
   const __FlashStringHelper* fpstr() const {
     switch (_type) {
       case Type::ProgMem: return reinterpret_cast<const __FlashStringHelper*>(reinterpret_cast<const char*>(_reference.progmem) + _offset);
@@ -325,23 +949,28 @@ public:
   }
 
   strref ltrim(char c) const {
-    size_t offset = 0;
-    while (offset < _length && charAt(offset) == c) {
-      offset++;
-    }
+    size_t offset = visit([c] (auto view) { return view.length() - view.ltrim(c).length(); });
     return substring(offset, _length - offset);
   }
 
   shared_str materialize() const {
+    return materialize(defaultAllocator());
+  }
+
+  /**
+   * Materialize the referenced string into a shared_str allocated from the given allocator
+   * (unless it already references a complete shared_str).
+   */
+  shared_str materialize(IAllocator& allocator) const {
     if (empty()) {
       return shared_str{};
     }
 
     switch (_type) {
-      case Type::String: return shared_str{ *this };
-      case Type::ConstChar: return shared_str{ *this };
-      case Type::ProgMem: return shared_str{ *this };
-      case Type::SharedStr: return isPartial() ? shared_str{ *this } : *_reference.sharedstr;
+      case Type::String: return shared_str{ *this, allocator };
+      case Type::ConstChar: return shared_str{ *this, allocator };
+      case Type::ProgMem: return shared_str{ *this, allocator };
+      case Type::SharedStr: return isPartial() ? shared_str{ *this, allocator } : shared_str{ _reference.sharedstr };
       default: return shared_str{};
     }
   }
@@ -386,6 +1015,21 @@ public:
     return array;
   }
 
+  /**
+   * Copy the referenced string into an array of characters allocated from the given allocator.
+   *
+   * NOTE: the caller is responsible for eventually de-allocating the array from the allocator,
+   * using the size length() + (zeroTerminated ? 1 : 0). Returns nullptr if the allocation fails.
+   */
+  char* toCharArray(bool zeroTerminated, IAllocator& allocator) const {
+    size_t arraySize = _length + (zeroTerminated ? 1 : 0);
+    char* array = static_cast<char*>(allocator.allocate(arraySize));
+    if (array != nullptr) {
+      copy(array, arraySize, zeroTerminated);
+    }
+    return array;
+  }
+
   size_t copy(char* dest, size_t destSize, bool zeroTerminated) const {
     if (destSize == 0) {
       return 0;
@@ -397,7 +1041,7 @@ public:
       case Type::String: memcpy(dest, _reference.string->c_str() + _offset, lengthToCopy); break;
       case Type::ConstChar: memcpy(dest, _reference.constchar + _offset, lengthToCopy); break;
       case Type::ProgMem: memcpy_P(dest, reinterpret_cast<const char*>(_reference.progmem) + _offset, lengthToCopy); break;
-      case Type::SharedStr: memcpy(dest, _reference.sharedstr->cstr() + _offset, lengthToCopy); break;
+      case Type::SharedStr: memcpy(dest, _reference.sharedstr->buffer() + _offset, lengthToCopy); break;
       default: lengthToCopy = 0; break;
     }
 
@@ -413,32 +1057,140 @@ public:
       case Type::String: return _reference.string->charAt(_offset + i);
       case Type::ConstChar: return _reference.constchar[_offset + i];
       case Type::ProgMem: return pgm_read_byte(reinterpret_cast<const char*>(_reference.progmem) + _offset + i);
-      case Type::SharedStr: return _reference.sharedstr->cstr()[_offset + i];
+      case Type::SharedStr: return _reference.sharedstr->buffer()[_offset + i];
       default: return '\0';
     }
   }
 
-  ssize_t indexOf(char c) const {
-    switch (_type) {
-      case Type::String: return _reference.string->indexOf(c, _offset);
-      case Type::ConstChar: {
-        auto p = static_cast<const char*>(memchr(_reference.constchar + _offset, c, _length));
-        return p ? p - (_reference.constchar + _offset) : -1;
-      }
-      case Type::ProgMem:
-      {
-        auto p = static_cast<const char*>(memchr_P(reinterpret_cast<const char*>(_reference.progmem) + _offset, c, _length));
-        return p ? p - (reinterpret_cast<const char*>(_reference.progmem) + _offset) : -1;
-      }
-      case Type::SharedStr: {
-        const char* str = _reference.sharedstr->cstr() + _offset;
-        auto p = static_cast<const char*>(memchr(str, c, _length));
-        return p ? p - str : -1;
-      }
-      default: return -1;
+  /**
+   * Hash of the contents (see hash32()), which is the same for all types of strings.
+   *
+   * For a strref covering a complete shared_str, the hash cached in the shared storage is used.
+   */
+  uint32_t hash() const {
+    if (_type == Type::SharedStr && _offset == 0u && _length == _reference.sharedstr->length) {
+      return _reference.sharedstr->hash();
     }
+    return visit([] (auto view) { return view.hash(); });
   }
 
+  ssize_t indexOf(char c, size_t from = 0) const {
+    return visit([c, from] (auto view) { return view.indexOf(c, from); });
+  }
+
+  /**
+   * Find the first occurrence of needle at or after from.
+   */
+  ssize_t find(const strref& needle, size_t from = 0) const {
+    return visit([&needle, from] (auto view) {
+      return needle.visit([&view, from] (auto needleView) { return view.find(needleView, from); });
+    });
+  }
+
+  /**
+   * Find the last occurrence of needle.
+   */
+  ssize_t rfind(const strref& needle) const {
+    return visit([&needle] (auto view) {
+      return needle.visit([&view] (auto needleView) { return view.rfind(needleView); });
+    });
+  }
+
+  /**
+   * Find the first character at or after from which is contained in set.
+   */
+  ssize_t findFirstOf(const strref& set, size_t from = 0) const {
+    return visit([&set, from] (auto view) {
+      return set.visit([&view, from] (auto setView) { return view.findFirstOf(setView, from); });
+    });
+  }
+
+  /**
+   * Lazily split this string at each occurrence of the given delimiter.
+   *
+   * The returned range yields slices of this string without allocating or copying
+   * anything. Consecutive delimiters result in empty slices.
+   */
+  split_range split(char delimiter) const;
+
+  /**
+   * Lazily split this string at each occurrence of the given delimiter string.
+   *
+   * An empty delimiter does not split the string at all.
+   */
+  split_range split(const strref& delimiter) const;
+
+  /**
+   * Lazily split this string at each character contained in the given set.
+   */
+  split_range splitAny(const strref& set) const;
+
+  /**
+   * Compare by content, ignoring the case of ASCII letters.
+   */
+  int compareIgnoreCase(const strref& other) const {
+    return visit([&other] (auto view) {
+      return other.visit([&view] (auto otherView) { return view.compareIgnoreCase(otherView); });
+    });
+  }
+
+  /**
+   * Check for equal contents, ignoring the case of ASCII letters.
+   */
+  bool equalsIgnoreCase(const strref& other) const {
+    return _length == other._length && visit([&other] (auto view) {
+      return other.visit([&view] (auto otherView) { return view.equalsIgnoreCase(otherView); });
+    });
+  }
+
+  /**
+   * Find the first occurrence of needle at or after from, ignoring the case of ASCII letters.
+   */
+  ssize_t findIgnoreCase(const strref& needle, size_t from = 0) const {
+    return visit([&needle, from] (auto view) {
+      return needle.visit([&view, from] (auto needleView) { return view.findIgnoreCase(needleView, from); });
+    });
+  }
+
+  /**
+   * Copy the referenced string into dest, converting ASCII letters to lower case.
+   */
+  size_t toLower(char* dest, size_t destSize, bool zeroTerminated) const {
+    size_t length = copy(dest, destSize, zeroTerminated);
+    toLowerAscii_W(dest, dest, length);
+    return length;
+  }
+
+  /**
+   * Copy the referenced string into dest, converting ASCII letters to upper case.
+   */
+  size_t toUpper(char* dest, size_t destSize, bool zeroTerminated) const {
+    size_t length = copy(dest, destSize, zeroTerminated);
+    toUpperAscii_W(dest, dest, length);
+    return length;
+  }
+
+  /**
+   * Check whether the referenced string is valid UTF-8.
+   */
+  bool isValidUtf8() const {
+    return visit([] (auto view) { return view.isValidUtf8(); });
+  }
+
+  /**
+   * Count the code points of the UTF-8 encoded string (see basic_strref::countCodePoints()).
+   */
+  size_t countCodePoints() const {
+    return visit([] (auto view) { return view.countCodePoints(); });
+  }
+
+  /**
+   * Iterate over the code points of the UTF-8 encoded string.
+   *
+   * Invalid or truncated sequences yield REPLACEMENT_CODE_POINT for a single byte.
+   */
+  codepoint_range codePoints() const;
+
   bool startsWith(const strref& prefix) const {
     if (prefix._length > _length) {
       return false;
@@ -462,32 +1214,32 @@ public:
         switch (other._type) {
           case Type::String: return memcmp(_reference.string->c_str() + _offset, other._reference.string->c_str() + other._offset, _length);
           case Type::ConstChar: return memcmp(_reference.string->c_str() + _offset, other._reference.constchar + other._offset, _length);
-          case Type::ProgMem: return memcmp_P(_reference.string->c_str() + _offset, reinterpret_cast<const char*>(other._reference.progmem) + other._offset, _length);
-          case Type::SharedStr: return memcmp(_reference.string->c_str() + _offset, other._reference.sharedstr->cstr() + other._offset, _length);
+          case Type::ProgMem: return memcmp_PB(_reference.string->c_str() + _offset, reinterpret_cast<const char*>(other._reference.progmem) + other._offset, _length);
+          case Type::SharedStr: return memcmp(_reference.string->c_str() + _offset, other._reference.sharedstr->buffer() + other._offset, _length);
           default: return 1;
         }
       case Type::ConstChar:
         switch (other._type) {
           case Type::String: return memcmp(_reference.constchar + _offset, other._reference.string->c_str() + other._offset, _length);
           case Type::ConstChar: return memcmp(_reference.constchar + _offset, other._reference.constchar + other._offset, _length);
-          case Type::ProgMem: return memcmp_P(_reference.constchar + _offset, reinterpret_cast<const char*>(other._reference.progmem) + other._offset, _length);
-          case Type::SharedStr: return memcmp(_reference.constchar + _offset, other._reference.sharedstr->cstr() + other._offset, _length);
+          case Type::ProgMem: return memcmp_PB(_reference.constchar + _offset, reinterpret_cast<const char*>(other._reference.progmem) + other._offset, _length);
+          case Type::SharedStr: return memcmp(_reference.constchar + _offset, other._reference.sharedstr->buffer() + other._offset, _length);
           default: return 1;
         }
       case Type::ProgMem:
         switch (other._type) {
-          case Type::String: return -memcmp_P(other._reference.string->c_str() + other._offset, reinterpret_cast<const char*>(_reference.progmem) + _offset, _length);
-          case Type::ConstChar: return -memcmp_P(other._reference.constchar + other._offset, reinterpret_cast<const char*>(_reference.progmem) + _offset, _length);
+          case Type::String: return -memcmp_PB(other._reference.string->c_str() + other._offset, reinterpret_cast<const char*>(_reference.progmem) + _offset, _length);
+          case Type::ConstChar: return -memcmp_PB(other._reference.constchar + other._offset, reinterpret_cast<const char*>(_reference.progmem) + _offset, _length);
           case Type::ProgMem: return memcmp_P2(reinterpret_cast<const char*>(_reference.progmem) + _offset, reinterpret_cast<const char*>(other._reference.progmem) + other._offset, _length);
-          case Type::SharedStr: return -memcmp_P(other._reference.sharedstr->cstr() + other._offset, reinterpret_cast<const char*>(_reference.progmem) + _offset, _length);
+          case Type::SharedStr: return -memcmp_PB(other._reference.sharedstr->buffer() + other._offset, reinterpret_cast<const char*>(_reference.progmem) + _offset, _length);
           default: return 1;
         }
       case Type::SharedStr:
         switch (other._type) {
-          case Type::String: return memcmp(_reference.sharedstr->cstr() + _offset, other._reference.string->c_str() + other._offset, _length);
-          case Type::ConstChar: return memcmp(_reference.sharedstr->cstr() + _offset, other._reference.constchar + other._offset, _length);
-          case Type::ProgMem: return memcmp_P(_reference.sharedstr->cstr() + _offset, reinterpret_cast<const char*>(other._reference.progmem) + other._offset, _length);
-          case Type::SharedStr: return memcmp(_reference.sharedstr->cstr() + _offset, other._reference.sharedstr->cstr() + other._offset, _length);
+          case Type::String: return memcmp(_reference.sharedstr->buffer() + _offset, other._reference.string->c_str() + other._offset, _length);
+          case Type::ConstChar: return memcmp(_reference.sharedstr->buffer() + _offset, other._reference.constchar + other._offset, _length);
+          case Type::ProgMem: return memcmp_PB(_reference.sharedstr->buffer() + _offset, reinterpret_cast<const char*>(other._reference.progmem) + other._offset, _length);
+          case Type::SharedStr: return memcmp(_reference.sharedstr->buffer() + _offset, other._reference.sharedstr->buffer() + other._offset, _length);
           default: return 1;
         }
       default: return -1;
@@ -519,6 +1271,195 @@ public:
   }
 };
 
+/**
+ * Lazy forward range of the slices of a string split at delimiters (see strref::split()).
+ */
+class split_range final {
+public:
+  enum struct Mode : uint8_t {
+    Char,
+    String,
+    AnyOf
+  };
+
+  class iterator final {
+    const split_range* _range;
+    strref _current;
+    strref _rest;
+    bool _last;
+    bool _end;
+
+    void advance() {
+      if (_last) {
+        _end = true;
+        _current = strref::EMPTY;
+        return;
+      }
+
+      ssize_t position;
+      size_t delimiterLength = 1u;
+      switch (_range->_mode) {
+        case Mode::Char: position = _rest.indexOf(_range->_delimiterChar); break;
+        case Mode::String:
+          delimiterLength = _range->_delimiter.length();
+          position = delimiterLength > 0u ? _rest.find(_range->_delimiter) : -1;
+          break;
+        case Mode::AnyOf: position = _rest.findFirstOf(_range->_delimiter); break;
+        default: position = -1; break;
+      }
+
+      if (position < 0) {
+        _current = _rest;
+        _rest = strref::EMPTY;
+        _last = true;
+      } else {
+        _current = _rest.leftmost(position);
+        _rest = _rest.skip(position + delimiterLength);
+      }
+    }
+
+  public:
+    iterator(const split_range* range, bool end) : _range(range), _current(), _rest(range->_string), _last(false), _end(end) {
+      if (!_end) {
+        advance();
+      }
+    }
+
+    const strref& operator*() const { return _current; }
+    const strref* operator->() const { return &_current; }
+
+    iterator& operator++() {
+      advance();
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator previous = *this;
+      advance();
+      return previous;
+    }
+
+    bool operator==(const iterator& other) const {
+      if (_end || other._end) {
+        return _end == other._end;
+      }
+      return _range == other._range && _last == other._last && _rest.length() == other._rest.length();
+    }
+
+    bool operator!=(const iterator& other) const {
+      return !(*this == other);
+    }
+  };
+
+private:
+  strref _string;
+  strref _delimiter;
+  char _delimiterChar;
+  Mode _mode;
+
+public:
+  split_range(const strref& string, char delimiter) : _string(string), _delimiter(), _delimiterChar(delimiter), _mode(Mode::Char) {}
+  split_range(const strref& string, const strref& delimiter, Mode mode) : _string(string), _delimiter(delimiter), _delimiterChar('\0'), _mode(mode) {}
+
+  iterator begin() const { return {this, false}; }
+  iterator end() const { return {this, true}; }
+};
+
+inline split_range strref::split(char delimiter) const {
+  return {*this, delimiter};
+}
+
+inline split_range strref::split(const strref& delimiter) const {
+  return {*this, delimiter, split_range::Mode::String};
+}
+
+inline split_range strref::splitAny(const strref& set) const {
+  return {*this, set, split_range::Mode::AnyOf};
+}
+
+/**
+ * Range of the code points in a UTF-8 encoded strref (see strref::codePoints()).
+ */
+class codepoint_range final {
+public:
+  class iterator final {
+    strref _rest;
+    uint32_t _codePoint;
+    size_t _sequenceLength;
+
+    void decode() {
+      if (_rest.empty()) {
+        _codePoint = 0;
+        _sequenceLength = 0;
+        return;
+      }
+
+      char buffer[4];
+      size_t size = _rest.copy(buffer, sizeof(buffer), false);
+      _sequenceLength = decodeUtf8(buffer, size, _codePoint);
+      if (_sequenceLength == 0 || _sequenceLength > size) {
+        _codePoint = REPLACEMENT_CODE_POINT;
+        _sequenceLength = 1;
+      }
+    }
+
+  public:
+    explicit iterator(const strref& rest) : _rest(rest), _codePoint(0), _sequenceLength(0) {
+      decode();
+    }
+
+    uint32_t operator*() const { return _codePoint; }
+
+    /**
+     * Remaining string, starting with the current code point.
+     */
+    const strref& rest() const { return _rest; }
+
+    iterator& operator++() {
+      _rest = _rest.skip(_sequenceLength);
+      decode();
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator previous = *this;
+      ++*this;
+      return previous;
+    }
+
+    bool operator==(const iterator& other) const {
+      return _rest.length() == other._rest.length();
+    }
+
+    bool operator!=(const iterator& other) const {
+      return !(*this == other);
+    }
+  };
+
+private:
+  strref _string;
+
+public:
+  explicit codepoint_range(const strref& string) : _string(string) {}
+
+  iterator begin() const { return iterator{_string}; }
+  iterator end() const { return iterator{strref::EMPTY}; }
+};
+
+inline codepoint_range strref::codePoints() const {
+  return codepoint_range{*this};
+}
+
+template<>
+inline basic_strref<RamTag>::operator strref() const {
+  return {_data, _length, _zeroTerminated};
+}
+
+template<>
+inline basic_strref<ProgmemTag>::operator strref() const {
+  return {reinterpret_cast<const __FlashStringHelper*>(_data), _length, _zeroTerminated};
+}
+
 /**
  * Lightweight/minimal wrapper around statically allocated strings / char arrays.
  */
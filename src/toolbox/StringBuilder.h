@@ -0,0 +1,260 @@
+#ifndef TOOLBOX_STRINGBUILDER_H_
+#define TOOLBOX_STRINGBUILDER_H_
+
+#include "String.h"
+#include "Conversion.h"
+#include "Allocator.h"
+#include "Streams.h"
+
+namespace toolbox {
+
+/**
+ * Builds strings in a chain of fixed-size chunks, instead of repeatedly re-allocating
+ * a growing buffer (like concatenating String instances does).
+ *
+ * Chunks are taken from an allocator (e.g. a PoolAllocator) or a caller-provided buffer.
+ * When no more chunks are available, the contents are either spilled to an output (if
+ * set) and the chunks are reused, or further appended contents are dropped and the
+ * builder is marked as truncated.
+ *
+ * The contents can be written to an output with writeTo()/flush() or turned into a
+ * single shared_str with materialize().
+ */
+class StringBuilder final {
+  struct Chunk final {
+    Chunk* next;
+    size_t used;
+
+    char* data() { return reinterpret_cast<char*>(this + 1); }
+  };
+
+  ArenaAllocator _arena;
+  IAllocator* _allocator;
+  IOutput* _output;
+  size_t _chunkSize;
+  Chunk* _first;
+  Chunk* _current;
+  size_t _length;
+  size_t _spilled;
+  bool _truncated;
+
+  Chunk* allocateChunk() {
+    Chunk* chunk = static_cast<Chunk*>(_allocator->allocate(sizeof(Chunk) + _chunkSize));
+    if (chunk != nullptr) {
+      chunk->next = nullptr;
+      chunk->used = 0u;
+    }
+    return chunk;
+  }
+
+  /**
+   * Get the space available in the current chunk, moving to the next chunk or
+   * spilling to the output when necessary.
+   */
+  size_t reserve() {
+    if (_current != nullptr && _current->used < _chunkSize) {
+      return _chunkSize - _current->used;
+    }
+
+    if (_current != nullptr && _current->next != nullptr) {
+      _current = _current->next;
+      return _chunkSize;
+    }
+
+    Chunk* chunk = allocateChunk();
+    if (chunk != nullptr) {
+      if (_current != nullptr) {
+        _current->next = chunk;
+      } else {
+        _first = chunk;
+      }
+      _current = chunk;
+      return _chunkSize;
+    }
+
+    if (_output != nullptr && _first != nullptr) {
+      flush();
+      return _chunkSize - _current->used;
+    }
+
+    return 0u;
+  }
+
+  void reuseChunks() {
+    for (Chunk* chunk = _first; chunk != nullptr; chunk = chunk->next) {
+      chunk->used = 0u;
+    }
+    _current = _first;
+    _length = 0u;
+  }
+
+  template<typename T>
+  StringBuilder& appendInteger(T value, int base) {
+    if (base != 10) {
+      return append(convert<T>::toString(value, base));
+    }
+    char digits[formatting::MAX_INTEGER_LENGTH];
+    return append(strref{digits, convert<T>::toChars(value, digits, sizeof(digits))});
+  }
+
+public:
+  static constexpr size_t DEFAULT_CHUNK_SIZE = 64u;
+
+  StringBuilder(IAllocator& allocator = defaultAllocator(), size_t chunkSize = DEFAULT_CHUNK_SIZE)
+    : _arena(nullptr, 0u), _allocator(&allocator), _output(nullptr), _chunkSize(chunkSize), _first(nullptr), _current(nullptr), _length(0u), _spilled(0u), _truncated(false) {}
+
+  /**
+   * Use chunks from the given buffer (including their bookkeeping overhead).
+   */
+  StringBuilder(char* buffer, size_t size, size_t chunkSize)
+    : _arena(buffer, size), _allocator(&_arena), _output(nullptr), _chunkSize(chunkSize), _first(nullptr), _current(nullptr), _length(0u), _spilled(0u), _truncated(false) {}
+
+  template<size_t N>
+  StringBuilder(char (&buffer)[N], size_t chunkSize = DEFAULT_CHUNK_SIZE) : StringBuilder(buffer, N, chunkSize) {}
+
+  StringBuilder(const StringBuilder& other) = delete;
+  StringBuilder& operator=(const StringBuilder& other) = delete;
+
+  ~StringBuilder() {
+    clear();
+  }
+
+  /**
+   * Set the output to spill the contents to when no more chunks are available.
+   */
+  StringBuilder& spillTo(IOutput& output) {
+    _output = &output;
+    return *this;
+  }
+
+  /**
+   * Number of characters currently held by the builder (i.e. not yet spilled).
+   */
+  size_t length() const {
+    return _length;
+  }
+
+  /**
+   * Number of characters written to the output so far.
+   */
+  size_t spilledLength() const {
+    return _spilled;
+  }
+
+  bool empty() const {
+    return _length == 0u;
+  }
+
+  /**
+   * Check if any contents were dropped because no more chunks were available.
+   */
+  bool isTruncated() const {
+    return _truncated;
+  }
+
+  StringBuilder& append(const strref& string) {
+    size_t offset = 0u;
+    while (offset < string.length()) {
+      size_t available = reserve();
+      if (available == 0u) {
+        _truncated = true;
+        break;
+      }
+      size_t copied = string.substring(offset, available).copy(_current->data() + _current->used, available, false);
+      _current->used += copied;
+      _length += copied;
+      offset += copied;
+    }
+    return *this;
+  }
+
+  StringBuilder& append(const char* string) {
+    return append(strref{string});
+  }
+
+  StringBuilder& append(const __FlashStringHelper* string) {
+    return append(strref{string});
+  }
+
+  StringBuilder& append(char c) {
+    if (reserve() == 0u) {
+      _truncated = true;
+    } else {
+      _current->data()[_current->used++] = c;
+      _length += 1u;
+    }
+    return *this;
+  }
+
+  StringBuilder& append(int value, int base = 10) { return appendInteger(value, base); }
+  StringBuilder& append(unsigned int value, int base = 10) { return appendInteger(value, base); }
+  StringBuilder& append(long value, int base = 10) { return appendInteger(value, base); }
+  StringBuilder& append(unsigned long value, int base = 10) { return appendInteger(value, base); }
+  StringBuilder& append(bool value, BoolFormat format = BoolFormat::Logic) { return append(convert<bool>::toString(value, format)); }
+
+  /**
+   * Write the contents to the given output, keeping them in the builder.
+   */
+  size_t writeTo(IOutput& output) const {
+    size_t written = 0u;
+    for (Chunk* chunk = _first; chunk != nullptr && chunk->used > 0u; chunk = chunk->next) {
+      written += output.write(strref{chunk->data(), chunk->used});
+      if (chunk == _current) {
+        break;
+      }
+    }
+    return written;
+  }
+
+  /**
+   * Write the contents to the output set with spillTo() and reuse the chunks afterwards.
+   */
+  size_t flush() {
+    if (_output == nullptr) {
+      return 0u;
+    }
+    size_t written = writeTo(*_output);
+    _spilled += written;
+    reuseChunks();
+    return written;
+  }
+
+  /**
+   * Copy the contents into a single shared_str.
+   */
+  shared_str materialize(IAllocator& allocator = defaultAllocator()) const {
+    return shared_str::build(_length, [this] (char* buffer, size_t) {
+      for (Chunk* chunk = _first; chunk != nullptr; chunk = chunk->next) {
+        memcpy(buffer, chunk->data(), chunk->used);
+        buffer += chunk->used;
+        if (chunk == _current) {
+          break;
+        }
+      }
+    }, allocator);
+  }
+
+  /**
+   * Release all chunks and reset the state of the builder.
+   */
+  void clear() {
+    Chunk* chunk = _first;
+    while (chunk != nullptr) {
+      Chunk* next = chunk->next;
+      _allocator->deallocate(chunk, sizeof(Chunk) + _chunkSize);
+      chunk = next;
+    }
+    _first = nullptr;
+    _current = nullptr;
+    _length = 0u;
+    _spilled = 0u;
+    _truncated = false;
+    if (_allocator == &_arena) {
+      _arena.reset();
+    }
+  }
+};
+
+}
+
+#endif
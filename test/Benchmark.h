@@ -0,0 +1,35 @@
+#ifndef TEST_BENCHMARK_H_
+#define TEST_BENCHMARK_H_
+
+#include <Arduino.h>
+#include <cstdio>
+
+/**
+ * Minimal helpers to compare the run time of a baseline against an optimized implementation.
+ *
+ * The numbers are only printed for information, the tests using these helpers must only
+ * assert on the results of both implementations being equal.
+ */
+namespace benchmark {
+
+/**
+ * Sink for results, to prevent the compiler from optimizing away the measured code.
+ */
+inline volatile long sink = 0;
+
+template<typename F>
+unsigned long measure(size_t iterations, F f) {
+  unsigned long start = micros();
+  for (size_t i = 0; i < iterations; ++i) {
+    sink = sink + static_cast<long>(f());
+  }
+  return micros() - start;
+}
+
+inline void report(const char* name, size_t iterations, unsigned long baseline, unsigned long optimized) {
+  printf("[benchmark] %s: %lu us baseline vs. %lu us optimized (%zu iterations)\n", name, baseline, optimized, iterations);
+}
+
+}
+
+#endif
@@ -0,0 +1,117 @@
+#include <yatest.h>
+#include <toolbox/Conversion.h>
+#include "Benchmark.h"
+
+using namespace yatest;
+
+namespace {
+
+/**
+ * Parsing like before, copying each (non zero-terminated) field for strtol().
+ */
+long parseWithStrtol(const toolbox::strref& field) {
+  toolbox::strref str = field.ensure_cstr();
+  return strtol(str.cstr(), nullptr, 10);
+}
+
+const char ROW[] = "1700000000,215,-12,45,1013,0,65535,-2147483647";
+
+static const TestSuite& BenchmarkConversion =
+    suite("Benchmark Conversion")
+        .tests("parse integer fields", []() {
+            toolbox::strref row{ROW};
+            long sumBaseline = 0;
+            long sumOptimized = 0;
+            for (const auto& field : row.split(',')) {
+              sumBaseline += parseWithStrtol(field);
+              sumOptimized += toolbox::convert<long>::fromString(field).get();
+            }
+            expect::equals(sumOptimized, sumBaseline, "same values");
+
+            const size_t iterations = 20000;
+            auto baseline = benchmark::measure(iterations, [&row]() {
+                long sum = 0;
+                for (const auto& field : row.split(',')) {
+                  sum += parseWithStrtol(field);
+                }
+                return sum;
+            });
+            auto optimized = benchmark::measure(iterations, [&row]() {
+                long sum = 0;
+                for (const auto& field : row.split(',')) {
+                  sum += toolbox::convert<long>::fromString(field).get();
+                }
+                return sum;
+            });
+            benchmark::report("parse integer fields (ensure_cstr + strtol vs. convert<long>)", iterations, baseline, optimized);
+        })
+        .tests("format integers", []() {
+            const int32_t values[] = {0, 7, -42, 1013, 65535, -2147483647, 1700000000, 215};
+            char expected[12];
+            char buffer[12];
+            for (int32_t value : values) {
+              ltoa(value, expected, 10);
+              size_t length = toolbox::convert<long>::toChars(value, buffer, sizeof(buffer));
+              expect::equals(toolbox::strref{buffer, length}, toolbox::strref{expected}, "same digits");
+            }
+
+            const size_t iterations = 100000;
+            auto baseline = benchmark::measure(iterations, [&values, i = size_t(0)]() mutable {
+                char buffer[12];
+                ltoa(values[i++ % 8], buffer, 10);
+                return buffer[0];
+            });
+            auto optimized = benchmark::measure(iterations, [&values, i = size_t(0)]() mutable {
+                char buffer[12];
+                toolbox::convert<long>::toChars(values[i++ % 8], buffer, sizeof(buffer));
+                return buffer[0];
+            });
+            benchmark::report("format integers (ltoa vs. convert<long>::toChars)", iterations, baseline, optimized);
+        })
+        .tests("64 bit integers", []() {
+            const char* const timestamps[] = {"1700000000123", "1700000000456", "18446744073709551615", "42", "9007199254740993", "1234567890123456"};
+
+            const size_t iterations = 100000;
+            auto baseline = benchmark::measure(iterations, [&timestamps, i = size_t(0)]() mutable {
+                return static_cast<long>(strtoull(timestamps[i++ % 6], nullptr, 10) & 0xFF);
+            });
+            auto optimized = benchmark::measure(iterations, [&timestamps, i = size_t(0)]() mutable {
+                return static_cast<long>(toolbox::convert<unsigned long long>::fromString(timestamps[i++ % 6]).get() & 0xFF);
+            });
+            benchmark::report("parse 64 bit integers (strtoull vs. convert<unsigned long long>)", iterations, baseline, optimized);
+
+            baseline = benchmark::measure(iterations, [i = 0ull]() mutable {
+                char buffer[24];
+                return snprintf(buffer, sizeof(buffer), "%llu", 1700000000000ull + (i++ << 20));
+            });
+            optimized = benchmark::measure(iterations, [i = 0ull]() mutable {
+                char buffer[24];
+                return static_cast<int>(toolbox::convert<unsigned long long>::toChars(1700000000000ull + (i++ << 20), buffer, sizeof(buffer)));
+            });
+            benchmark::report("format 64 bit integers (snprintf vs. convert<unsigned long long>)", iterations, baseline, optimized);
+        })
+        .tests("floating point numbers", []() {
+            const double values[] = {21.53, -0.1, 1013.25, 1700000000.123, 6.02214076e23, 1.5e-9, 42.0, 3.14159265358979};
+            const char* const strings[] = {"21.53", "-0.1", "1013.25", "1700000000.123", "6.02214076e23", "1.5e-9", "42", "3.14159265358979"};
+
+            const size_t iterations = 100000;
+            auto baseline = benchmark::measure(iterations, [&values, i = size_t(0)]() mutable {
+                char buffer[32];
+                return snprintf(buffer, sizeof(buffer), "%.17g", values[i++ % 8]);
+            });
+            auto optimized = benchmark::measure(iterations, [&values, i = size_t(0)]() mutable {
+                char buffer[toolbox::formatting::MAX_FLOATING_POINT_LENGTH];
+                return static_cast<int>(toolbox::convert<double>::toChars(values[i++ % 8], buffer, sizeof(buffer)));
+            });
+            benchmark::report("format doubles (snprintf %.17g vs. convert<double>, shortest)", iterations, baseline, optimized);
+
+            baseline = benchmark::measure(iterations, [&strings, i = size_t(0)]() mutable {
+                return strtod(strings[i++ % 8], nullptr) > 1.0;
+            });
+            optimized = benchmark::measure(iterations, [&strings, i = size_t(0)]() mutable {
+                return toolbox::convert<double>::fromString(strings[i++ % 8]).get() > 1.0;
+            });
+            benchmark::report("parse doubles (strtod vs. convert<double>)", iterations, baseline, optimized);
+        });
+
+}
\ No newline at end of file
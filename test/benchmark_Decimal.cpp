@@ -0,0 +1,167 @@
+#include <yatest.h>
+#include <toolbox/Decimal.h>
+#include "Benchmark.h"
+#include <cmath>
+
+using namespace yatest;
+
+namespace {
+
+/**
+ * The former implementation of Decimal::toString(), formatting with snprintf and inserting
+ * the dot and leading zeros afterwards.
+ */
+size_t formatWithSnprintf(int64_t number, uint8_t decimalPlaces, char* buffer) {
+  int length = snprintf(buffer, toolbox::Decimal::MAX_STRING_LENGTH + 1, "%lli", (long long) number);
+  if (decimalPlaces > 0) {
+    int signLength = number < 0 ? 1 : 0;
+    length -= signLength;
+    if (decimalPlaces >= length) {
+      memmove(buffer + signLength + decimalPlaces - length + 1, buffer + signLength, length + 1);
+      memset(buffer + signLength, '0', decimalPlaces - length + 1);
+      length += decimalPlaces - length + 1;
+    }
+    memmove(buffer + signLength + length - decimalPlaces + 1, buffer + signLength + length - decimalPlaces, decimalPlaces + 1);
+    buffer[signLength + length - decimalPlaces] = '.';
+    length += 1;
+  }
+  return length + (number < 0 ? 1 : 0);
+}
+
+/**
+ * The former implementation of Decimal::fromString(), copying the string to a buffer,
+ * then the decimal places once more over the dot, and parsing the result with strtoll().
+ */
+bool parseWithStrtoll(const toolbox::strref& string, int64_t& number, uint8_t& decimalPlaces) {
+  static char buffer[toolbox::Decimal::MAX_STRING_LENGTH + 1];
+  if (string.length() > toolbox::Decimal::MAX_STRING_LENGTH) {
+    return false;
+  }
+  string.copy(buffer, toolbox::Decimal::MAX_STRING_LENGTH, true);
+  decimalPlaces = 0;
+  ssize_t dotPosition = string.indexOf('.');
+  if (dotPosition >= 0) {
+    decimalPlaces = string.skip(dotPosition + 1).copy(buffer + dotPosition, toolbox::Decimal::MAX_STRING_LENGTH - dotPosition, true);
+  }
+  char* end = nullptr;
+  number = strtoll(buffer, &end, 10);
+  return *end == '\0';
+}
+
+const char* const STRINGS[] = {"123.45", "-0.005", "214748.3647", "-98765432.101234", "0.0", "3.1415926", "-4.20", "7"};
+
+const int64_t NUMBERS[] = {12345, -5, 2147483647, -98765432101234LL, 0, 31415926, -420, 7};
+const uint8_t DECIMAL_PLACES[] = {2, 3, 4, 6, 1, 7, 2, 0};
+
+const char* const READINGS[] = {"1.250", "0.875", "2.003", "0.412", "3.100", "1.999", "0.007", "4.560"};
+
+static const TestSuite& BenchmarkDecimal =
+    suite("Benchmark Decimal")
+        .tests("format decimals", []() {
+            char expected[toolbox::Decimal::MAX_STRING_LENGTH + 1];
+            char actual[toolbox::Decimal::MAX_STRING_LENGTH + 1];
+            for (size_t i = 0; i < 8; ++i) {
+                const size_t length = formatWithSnprintf(NUMBERS[i], DECIMAL_PLACES[i], expected);
+                expect::equals(toolbox::Decimal::fromFixedPoint(NUMBERS[i], DECIMAL_PLACES[i]).toString(actual), toolbox::strref{expected, length});
+            }
+
+            const size_t iterations = 100000;
+            char buffer[toolbox::Decimal::MAX_STRING_LENGTH + 1];
+            auto baseline = benchmark::measure(iterations, [&buffer, i = size_t(0)]() mutable {
+                const size_t index = i++ % 8;
+                return formatWithSnprintf(NUMBERS[index], DECIMAL_PLACES[index], buffer);
+            });
+            auto optimized = benchmark::measure(iterations, [&buffer, i = size_t(0)]() mutable {
+                const size_t index = i++ % 8;
+                return toolbox::Decimal::fromFixedPoint(NUMBERS[index], DECIMAL_PLACES[index]).toChars(buffer, sizeof(buffer));
+            });
+            benchmark::report("format decimals (snprintf + memmove vs. Decimal::toChars)", iterations, baseline, optimized);
+        })
+        .tests("parse decimals", []() {
+            toolbox::strref strings[8];
+            for (size_t i = 0; i < 8; ++i) {
+                strings[i] = toolbox::strref{STRINGS[i]};
+                int64_t number;
+                uint8_t decimalPlaces;
+                expect::isTrue(parseWithStrtoll(strings[i], number, decimalPlaces), STRINGS[i]);
+                const toolbox::Decimal decimal = toolbox::Decimal::fromString(strings[i]).get();
+                expect::equals(decimal.decimalPlaces(), decimalPlaces, STRINGS[i]);
+                expect::equals(toolbox::Decimal{decimal}.toFixedPoint(decimalPlaces), number, STRINGS[i]);
+            }
+
+            const size_t iterations = 100000;
+            auto baseline = benchmark::measure(iterations, [&strings, i = size_t(0)]() mutable {
+                int64_t number = 0;
+                uint8_t decimalPlaces = 0;
+                parseWithStrtoll(strings[i++ % 8], number, decimalPlaces);
+                return number + decimalPlaces;
+            });
+            auto optimized = benchmark::measure(iterations, [&strings, i = size_t(0)]() mutable {
+                toolbox::Decimal decimal = toolbox::Decimal::fromString(strings[i++ % 8]).get();
+                return decimal.toFixedPoint(decimal.decimalPlaces()) + decimal.decimalPlaces();
+            });
+            benchmark::report("parse decimals (copies + strtoll vs. Decimal::fromString)", iterations, baseline, optimized);
+        })
+        .tests("sum and compare", []() {
+            double doubles[8];
+            toolbox::Decimal decimals[8];
+            for (size_t i = 0; i < 8; ++i) {
+                doubles[i] = strtod(READINGS[i], nullptr);
+                decimals[i] = toolbox::Decimal::fromString(READINGS[i]).get();
+            }
+            const double doubleLimit = 2.0;
+            const toolbox::Decimal decimalLimit = toolbox::Decimal::fromFixedPoint(2000, 3);
+
+            const size_t iterations = 100000;
+            auto baseline = benchmark::measure(iterations, [&doubles, &doubleLimit, i = size_t(0)]() mutable {
+                double sum = 0.0;
+                size_t above = 0;
+                for (size_t j = 0; j < 8; ++j) {
+                    sum += doubles[(i + j) % 8];
+                    above += doubles[(i + j) % 8] > doubleLimit ? 1u : 0u;
+                }
+                ++i;
+                return size_t(sum) + above;
+            });
+            auto optimized = benchmark::measure(iterations, [&decimals, &decimalLimit, i = size_t(0)]() mutable {
+                toolbox::Decimal sum = toolbox::Decimal::fromFixedPoint(0, 3);
+                bool overflow = false;
+                size_t above = 0;
+                for (size_t j = 0; j < 8; ++j) {
+                    const toolbox::Maybe<toolbox::Decimal> next = sum + decimals[(i + j) % 8];
+                    overflow |= !next.available();
+                    sum = next.get();
+                    above += decimals[(i + j) % 8] > decimalLimit ? 1u : 0u;
+                }
+                ++i;
+                return size_t(sum.integer()) + above + (overflow ? 1u : 0u);
+            });
+            benchmark::report("sum and compare 8 readings (double vs. Decimal)", iterations, baseline, optimized);
+        })
+        .tests("tariff", []() {
+            double doubles[8];
+            toolbox::Decimal decimals[8];
+            for (size_t i = 0; i < 8; ++i) {
+                doubles[i] = strtod(READINGS[i], nullptr);
+                decimals[i] = toolbox::Decimal::fromString(READINGS[i]).get();
+            }
+            const double doublePrice = 0.3127;
+            const toolbox::Decimal decimalPrice = toolbox::Decimal::fromFixedPoint(3127, 4);
+            for (size_t i = 0; i < 8; ++i) {
+                const double cost = std::round(doubles[i] * doublePrice * 100.0) / 100.0;
+                expect::equals(decimals[i].multiply(decimalPrice, 2).get().toFixedPoint(2), int64_t(std::round(cost * 100.0)), READINGS[i]);
+            }
+
+            const size_t iterations = 100000;
+            auto baseline = benchmark::measure(iterations, [&doubles, &doublePrice, i = size_t(0)]() mutable {
+                const double cost = std::round(doubles[i++ % 8] * doublePrice * 100.0) / 100.0;
+                return size_t(cost * 100.0);
+            });
+            auto optimized = benchmark::measure(iterations, [&decimals, &decimalPrice, i = size_t(0)]() mutable {
+                toolbox::Decimal cost = decimals[i++ % 8].multiply(decimalPrice, 2).get();
+                return size_t(cost.toFixedPoint(2));
+            });
+            benchmark::report("cost of a reading rounded to cents (double vs. Decimal)", iterations, baseline, optimized);
+        });
+
+}
@@ -0,0 +1,115 @@
+#include <yatest.h>
+#include <toolbox/Encoding.h>
+#include "Benchmark.h"
+
+using namespace yatest;
+
+namespace {
+
+const char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/**
+ * Write the hex digits of each byte one at a time to the output, as when printing a dump.
+ */
+size_t writeHexBytewise(const uint8_t* data, size_t size, toolbox::IOutput& output) {
+  size_t written = 0;
+  for (size_t i = 0; i < size; ++i) {
+    written += output.write("0123456789abcdef"[data[i] >> 4]);
+    written += output.write("0123456789abcdef"[data[i] & 0x0F]);
+  }
+  return written;
+}
+
+/**
+ * Decode base64 by searching each character in the alphabet.
+ */
+size_t decodeBase64Bytewise(const char* str, size_t length, uint8_t* dest) {
+  size_t size = 0;
+  uint32_t group = 0;
+  size_t count = 0;
+  for (size_t i = 0; i < length && str[i] != '='; ++i) {
+    const char* position = strchr(BASE64_ALPHABET, str[i]);
+    if (position == nullptr) {
+      return 0;
+    }
+    group = (group << 6) | uint32_t(position - BASE64_ALPHABET);
+    if (++count == 4) {
+      dest[size++] = uint8_t(group >> 16);
+      dest[size++] = uint8_t(group >> 8);
+      dest[size++] = uint8_t(group);
+      group = 0;
+      count = 0;
+    }
+  }
+  if (count == 3) {
+    dest[size++] = uint8_t(group >> 10);
+    dest[size++] = uint8_t(group >> 2);
+  } else if (count == 2) {
+    dest[size++] = uint8_t(group >> 4);
+  }
+  return size;
+}
+
+/**
+ * Output into a buffer which is reused for each iteration.
+ */
+class BufferOutput final : public toolbox::IOutput {
+public:
+  char buffer[512];
+  size_t length = 0;
+
+  size_t write(char c) override {
+    buffer[length++ % sizeof(buffer)] = c;
+    return 1;
+  }
+
+  size_t write(const toolbox::strref& data) override {
+    length = length % sizeof(buffer);
+    data.copy(buffer + length, sizeof(buffer) - length, false);
+    length += data.length();
+    return data.length();
+  }
+};
+
+static const TestSuite& BenchmarkEncoding =
+    suite("Benchmark Encoding")
+        .tests("hex", []() {
+            uint8_t blob[256];
+            for (size_t i = 0; i < sizeof(blob); ++i) {
+                blob[i] = uint8_t(i * 31u + 7u);
+            }
+
+            BufferOutput expected;
+            writeHexBytewise(blob, sizeof(blob), expected);
+            BufferOutput actual;
+            toolbox::encoding::encodeHex(toolbox::ram_strref{reinterpret_cast<const char*>(blob), sizeof(blob)}, actual);
+            expect::isTrue(memcmp(expected.buffer, actual.buffer, 2 * sizeof(blob)) == 0, "same characters");
+
+            const size_t iterations = 20000;
+            BufferOutput output;
+            auto baseline = benchmark::measure(iterations, [&]() { return writeHexBytewise(blob, sizeof(blob), output); });
+            auto optimized = benchmark::measure(iterations, [&]() {
+                return toolbox::encoding::encodeHex(toolbox::ram_strref{reinterpret_cast<const char*>(blob), sizeof(blob)}, output);
+            });
+            benchmark::report("hex encode 256 bytes to output (byte-wise vs. encodeHex)", iterations, baseline, optimized);
+        })
+        .tests("base64", []() {
+            uint8_t blob[192];
+            for (size_t i = 0; i < sizeof(blob); ++i) {
+                blob[i] = uint8_t(i * 31u + 7u);
+            }
+            char encoded[toolbox::encoding::base64Length(sizeof(blob))];
+            toolbox::encoding::encodeBase64(toolbox::ram_strref{reinterpret_cast<const char*>(blob), sizeof(blob)}, encoded, sizeof(encoded));
+            uint8_t decoded[sizeof(blob)];
+            expect::equals(decodeBase64Bytewise(encoded, sizeof(encoded), decoded), sizeof(blob), "same length");
+            expect::equals(toolbox::encoding::decodeBase64(toolbox::ram_strref{encoded, sizeof(encoded)}, decoded, sizeof(decoded)).get(), sizeof(blob), "same length");
+
+            const size_t iterations = 20000;
+            auto baseline = benchmark::measure(iterations, [&]() { return decodeBase64Bytewise(encoded, sizeof(encoded), decoded); });
+            auto optimized = benchmark::measure(iterations, [&]() {
+                return toolbox::encoding::decodeBase64(toolbox::ram_strref{encoded, sizeof(encoded)}, decoded, sizeof(decoded)).get();
+            });
+            benchmark::report("base64 decode 256 characters (alphabet search vs. decodeBase64)", iterations, baseline, optimized);
+        });
+
+}
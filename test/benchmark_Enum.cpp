@@ -0,0 +1,82 @@
+#include <yatest.h>
+#include <toolbox/Enum.h>
+#include "Benchmark.h"
+
+using namespace yatest;
+
+namespace {
+
+enum struct Command : uint8_t {
+  Start, Stop, Pause, Resume, Reset, Reboot, Status, Version,
+  Get, Set, List, Clear, Load, Save, Enable, Disable,
+  Connect, Disconnect, Subscribe, Unsubscribe, Publish, Ping, Calibrate, Sleep
+};
+
+}
+
+template<>
+struct toolbox::enum_names<Command> {
+  static constexpr toolbox::enum_name<Command> entries[] = {
+    {Command::Start, "start"}, {Command::Stop, "stop"}, {Command::Pause, "pause"}, {Command::Resume, "resume"},
+    {Command::Reset, "reset"}, {Command::Reboot, "reboot"}, {Command::Status, "status"}, {Command::Version, "version"},
+    {Command::Get, "get"}, {Command::Set, "set"}, {Command::List, "list"}, {Command::Clear, "clear"},
+    {Command::Load, "load"}, {Command::Save, "save"}, {Command::Enable, "enable"}, {Command::Disable, "disable"},
+    {Command::Connect, "connect"}, {Command::Disconnect, "disconnect"}, {Command::Subscribe, "subscribe"}, {Command::Unsubscribe, "unsubscribe"},
+    {Command::Publish, "publish"}, {Command::Ping, "ping"}, {Command::Calibrate, "calibrate"}, {Command::Sleep, "sleep"},
+  };
+};
+
+namespace {
+
+const char* const INPUTS[] = {"status", "publish", "sleep", "start", "unsubscribe", "get", "calibrate", "unknown"};
+
+/**
+ * Compare with each name one after another, like the hand-written converters.
+ */
+int findByComparison(const toolbox::strref& string) {
+  const auto& entries = toolbox::enum_names<Command>::entries;
+  for (const auto& entry : entries) {
+    if (string == entry.name) {
+      return int(entry.value);
+    }
+  }
+  return -1;
+}
+
+int findByHash(const toolbox::strref& string) {
+  toolbox::Maybe<Command> value = toolbox::convert<Command>::fromString(string);
+  return value.available() ? int(value.get()) : -1;
+}
+
+static const TestSuite& BenchmarkEnum =
+    suite("Benchmark Enum")
+        .tests("parse command names", []() {
+            for (const char* input : INPUTS) {
+                expect::equals(findByHash(input), findByComparison(input), input);
+            }
+
+            const size_t iterations = 100000;
+            auto baseline = benchmark::measure(iterations, [i = size_t(0)]() mutable {
+                return findByComparison(INPUTS[i++ % 8]);
+            });
+            auto optimized = benchmark::measure(iterations, [i = size_t(0)]() mutable {
+                return findByHash(INPUTS[i++ % 8]);
+            });
+            benchmark::report("parse command names (comparisons vs. convert<Enum>)", iterations, baseline, optimized);
+
+            baseline = benchmark::measure(iterations, [i = size_t(0)]() mutable {
+                const Command command = Command(i++ % 24);
+                for (const auto& entry : toolbox::enum_names<Command>::entries) {
+                    if (entry.value == command) {
+                        return strlen(entry.name);
+                    }
+                }
+                return size_t(0);
+            });
+            optimized = benchmark::measure(iterations, [i = size_t(0)]() mutable {
+                return toolbox::convert<Command>::toString(Command(i++ % 24)).length();
+            });
+            benchmark::report("format command names (search vs. convert<Enum>)", iterations, baseline, optimized);
+        });
+
+}
@@ -0,0 +1,55 @@
+#include <yatest.h>
+#include <toolbox/String.h>
+#include "Benchmark.h"
+
+using namespace yatest;
+
+namespace {
+
+/**
+ * Byte-wise 32-bit FNV-1a as baseline.
+ */
+uint32_t fnv1a(const char* data, size_t length) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < length; ++i) {
+    h = (h ^ uint8_t(data[i])) * 16777619u;
+  }
+  return h;
+}
+
+const char* const SHORT_KEYS[] = {"id", "temp", "unit", "value", "state", "rssi", "topic/a", "sensor/7"};
+const char LONG_KEY[] = "home/first-floor/living-room/sensors/climate/temperature/current/value/celsius";
+
+static const TestSuite& BenchmarkHash =
+    suite("Benchmark Hash")
+        .tests("short keys", []() {
+            const size_t iterations = 100000;
+            auto baseline = benchmark::measure(iterations, [i = size_t(0)]() mutable {
+                const char* key = SHORT_KEYS[i++ % 8];
+                return fnv1a(key, strlen(key));
+            });
+            auto optimized = benchmark::measure(iterations, [i = size_t(0)]() mutable {
+                const char* key = SHORT_KEYS[i++ % 8];
+                return toolbox::hash32(key, strlen(key));
+            });
+            benchmark::report("hash short keys (FNV-1a vs. hash32)", iterations, baseline, optimized);
+        })
+        .tests("long keys", []() {
+            const size_t iterations = 100000;
+            const size_t length = strlen(LONG_KEY);
+            auto baseline = benchmark::measure(iterations, [length]() { return fnv1a(LONG_KEY, length); });
+            auto optimized = benchmark::measure(iterations, [length]() { return toolbox::hash32(LONG_KEY, length); });
+            benchmark::report("hash long key (FNV-1a vs. hash32)", iterations, baseline, optimized);
+        })
+        .tests("materialized keys", []() {
+            toolbox::strref key{LONG_KEY};
+            toolbox::strref shared{key.materialize()};
+            expect::equals(shared.hash(), key.hash(), "same hash");
+
+            const size_t iterations = 100000;
+            auto baseline = benchmark::measure(iterations, [&key]() { return key.hash(); });
+            auto optimized = benchmark::measure(iterations, [&shared]() { return shared.hash(); });
+            benchmark::report("hash long key (uncached vs. cached in shared_str)", iterations, baseline, optimized);
+        });
+
+}
@@ -0,0 +1,86 @@
+#include <yatest.h>
+#include <toolbox/String.h>
+#include <toolbox/Streams.h>
+#include "Benchmark.h"
+
+using namespace yatest;
+
+namespace {
+
+const char COMMAND_TABLE[] PROGMEM = "status;restart;config/network/wifi/ssid;config/network/wifi/password;config/mqtt/broker";
+const char COMMAND_TABLE_COPY[] PROGMEM = "status;restart;config/network/wifi/ssid;config/network/wifi/password;config/mqtt/broker";
+
+/**
+ * Previous byte-wise implementations to compare against.
+ */
+int bytewise_memcmp_P2(PGM_P str1P, PGM_P str2P, size_t size) {
+  int result = 0;
+  while (size > 0) {
+    char ch1 = pgm_read_byte(str1P++);
+    char ch2 = pgm_read_byte(str2P++);
+    result = ch1 - ch2;
+    if (result != 0) {
+      break;
+    }
+    size--;
+  }
+  return result;
+}
+
+PGM_P bytewise_memchr_P(PGM_P strP, char c, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    if (static_cast<char>(pgm_read_byte(strP + i)) == c) {
+      return strP + i;
+    }
+  }
+  return nullptr;
+}
+
+class CountingPrint final : public Print {
+public:
+  size_t count = 0;
+  size_t write(uint8_t) override { ++count; return 1; }
+  size_t write(const uint8_t*, size_t size) override { count += size; return size; }
+};
+
+static const TestSuite& BenchmarkProgmem =
+    suite("Benchmark PROGMEM access")
+        .tests("compare PROGMEM with PROGMEM", []() {
+            const size_t length = strlen_P(COMMAND_TABLE);
+            expect::equals(toolbox::memcmp_P2(COMMAND_TABLE, COMMAND_TABLE_COPY, length), bytewise_memcmp_P2(COMMAND_TABLE, COMMAND_TABLE_COPY, length), "same result");
+
+            const size_t iterations = 100000;
+            auto baseline = benchmark::measure(iterations, [&]() { return bytewise_memcmp_P2(COMMAND_TABLE, COMMAND_TABLE_COPY, length); });
+            auto optimized = benchmark::measure(iterations, [&]() { return toolbox::memcmp_P2(COMMAND_TABLE, COMMAND_TABLE_COPY, length); });
+            benchmark::report("memcmp_P2", iterations, baseline, optimized);
+        })
+        .tests("find character in PROGMEM", []() {
+            const size_t length = strlen_P(COMMAND_TABLE);
+            expect::isTrue(toolbox::memchr_PB(COMMAND_TABLE, 'k', length) == bytewise_memchr_P(COMMAND_TABLE, 'k', length), "same result");
+
+            const size_t iterations = 100000;
+            auto baseline = benchmark::measure(iterations, [&]() { return bytewise_memchr_P(COMMAND_TABLE, 'k', length) != nullptr; });
+            auto optimized = benchmark::measure(iterations, [&]() { return toolbox::memchr_PB(COMMAND_TABLE, 'k', length) != nullptr; });
+            benchmark::report("memchr_PB", iterations, baseline, optimized);
+        })
+        .tests("write partial PROGMEM string to Print", []() {
+            toolbox::strref command = toolbox::strref{FPSTR(COMMAND_TABLE)}.leftmost(80);
+            CountingPrint print;
+            toolbox::PrintOutput output {print};
+
+            const size_t iterations = 100000;
+            auto baseline = benchmark::measure(iterations, [&]() {
+                PGM_P p = reinterpret_cast<PGM_P>(command.fpstr());
+                size_t n = 0;
+                while (n < command.length()) {
+                    if (output.write(static_cast<char>(pgm_read_byte(p++)))) n++;
+                    else break;
+                }
+                return n;
+            });
+            auto optimized = benchmark::measure(iterations, [&]() { return output.write(command); });
+            expect::equals(print.count, 2 * iterations * 80u, "all bytes written");
+            benchmark::report("PrintOutput::write", iterations, baseline, optimized);
+        });
+
+}
@@ -0,0 +1,46 @@
+#include <yatest.h>
+#include <toolbox/String.h>
+#include "Benchmark.h"
+
+using namespace yatest;
+
+namespace {
+
+/*
+ * The reference counter is chosen at build time, so yatest.sh runs these benchmarks once
+ * per configuration. Both runs use the same baseline (strref copies of a const char*,
+ * which count nothing), so their lines can be compared side by side.
+ */
+#ifdef TOOLBOX_ATOMIC_REFCOUNT
+#define REFCOUNT_CONFIGURATION "atomic"
+#else
+#define REFCOUNT_CONFIGURATION "plain"
+#endif
+
+static const TestSuite& BenchmarkRefCount =
+    suite("Benchmark reference counting")
+        .tests("copy and release shared_str", []() {
+            toolbox::strref plain{"network/worker/shared/payload"};
+            toolbox::shared_str shared = plain.materialize();
+            const size_t iterations = 1000000;
+            auto baseline = benchmark::measure(iterations, [&plain]() {
+                toolbox::strref copy{plain};
+                return copy.length();
+            });
+            auto optimized = benchmark::measure(iterations, [&shared]() {
+                toolbox::shared_str copy{shared};
+                return copy.length();
+            });
+            benchmark::report("copy and release (const char vs. shared_str, " REFCOUNT_CONFIGURATION " reference counter)", iterations, baseline, optimized);
+            expect::equals(shared.useCount(), 1u, "all copies released");
+        })
+        .tests("copy and release strref of shared_str", []() {
+            toolbox::strref plain{"network/worker/shared/payload"};
+            toolbox::strref shared = plain.materialize();
+            const size_t iterations = 1000000;
+            auto baseline = benchmark::measure(iterations, [&plain]() { return toolbox::strref{plain}.length(); });
+            auto optimized = benchmark::measure(iterations, [&shared]() { return toolbox::strref{shared}.length(); });
+            benchmark::report("copy and release strref (const char vs. shared_str, " REFCOUNT_CONFIGURATION " reference counter)", iterations, baseline, optimized);
+        });
+
+}
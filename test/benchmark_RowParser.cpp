@@ -0,0 +1,70 @@
+#include <yatest.h>
+#include <toolbox/RowParser.h>
+#include "Benchmark.h"
+
+using namespace yatest;
+
+namespace {
+
+const char FRAMES[] = "12,345,-7,88\n1013,-42,0,65535\n7,8,9,10\n-1,-22,-333,-4444\n";
+
+/**
+ * Parse the fields one after another like convert<int> did originally (copying each
+ * field which is not zero-terminated), returning the sum of all values.
+ */
+long parseFieldByFieldWithStrtol(toolbox::strref input) {
+  long sum = 0;
+  while (!input.empty()) {
+    for (int i = 0; i < 4; ++i) {
+      toolbox::strref str = input.leftmost(input.findFirstOf(",\n")).ensure_cstr();
+      char* end;
+      sum += strtol(str.cstr(), &end, 10);
+      input = input.skip(str.length() + 1);
+    }
+  }
+  return sum;
+}
+
+/**
+ * Parse the fields one after another with convert<int>, returning the sum of all values.
+ */
+long parseFieldByField(toolbox::strref input) {
+  long sum = 0;
+  while (!input.empty()) {
+    for (int i = 0; i < 4; ++i) {
+      toolbox::strref next;
+      sum += toolbox::convert<int>::fromString(input, &next).get();
+      input = next.skip(1);
+    }
+  }
+  return sum;
+}
+
+long parseRows(toolbox::strref input) {
+  long sum = 0;
+  int values[4];
+  while (!input.empty()) {
+    toolbox::parseRow(input, ',', values, nullptr, &input);
+    sum += values[0] + values[1] + values[2] + values[3];
+  }
+  return sum;
+}
+
+static const TestSuite& BenchmarkRowParser =
+    suite("Benchmark RowParser")
+        .tests("integer rows", []() {
+            toolbox::strref input{FRAMES};
+            expect::equals(parseRows(input), parseFieldByField(input), "same values");
+            expect::equals(parseRows(input), parseFieldByFieldWithStrtol(input), "same values as strtol");
+
+            const size_t iterations = 20000;
+            auto baseline = benchmark::measure(iterations, [&input]() { return parseFieldByFieldWithStrtol(input); });
+            auto optimized = benchmark::measure(iterations, [&input]() { return parseRows(input); });
+            benchmark::report("parse integer rows (field by field with ensure_cstr + strtol vs. parseRow)", iterations, baseline, optimized);
+
+            baseline = benchmark::measure(iterations, [&input]() { return parseFieldByField(input); });
+            optimized = benchmark::measure(iterations, [&input]() { return parseRows(input); });
+            benchmark::report("parse integer rows (field by field with convert<int> vs. parseRow)", iterations, baseline, optimized);
+        });
+
+}
@@ -0,0 +1,67 @@
+#include <yatest.h>
+#include <toolbox/String.h>
+#include "Benchmark.h"
+
+using namespace yatest;
+
+namespace {
+
+/**
+ * Byte-wise UTF-8 validation as baseline.
+ */
+bool isValidUtf8Bytewise(const char* data, size_t length) {
+  size_t i = 0;
+  while (i < length) {
+    uint32_t codePoint;
+    size_t sequenceLength = toolbox::decodeUtf8(data + i, length - i, codePoint);
+    if (sequenceLength == 0 || sequenceLength > length - i) {
+      return false;
+    }
+    i += sequenceLength;
+  }
+  return true;
+}
+
+/**
+ * Byte-wise code point count as baseline.
+ */
+size_t countCodePointsBytewise(const char* data, size_t length) {
+  size_t count = 0;
+  for (size_t i = 0; i < length; ++i) {
+    count += (uint8_t(data[i]) & 0xC0u) != 0x80u;
+  }
+  return count;
+}
+
+const char MOSTLY_ASCII[] = "{\"topic\":\"home/living-room/climate\",\"temperature\":21.5,\"unit\":\"\xC2\xB0" "C\",\"humidity\":45,\"state\":\"ok\"}";
+const char MIXED[] = "Gr\xC3\xBC\xC3\x9F" "e aus K\xC3\xB6ln \xE2\x80\x93 \xE6\x9D\xB1\xE4\xBA\xAC\xE9\x83\xBD \xF0\x9F\x98\x80 \xCE\xB1\xCE\xB2\xCE\xB3 caf\xC3\xA9 \xE2\x82\xAC 12,50";
+
+void compare(const char* name, const char* text) {
+  const size_t length = strlen(text);
+  toolbox::strref view{text, length};
+  expect::isTrue(view.isValidUtf8(), "valid");
+  expect::equals(view.countCodePoints(), countCodePointsBytewise(text, length), "same count");
+
+  const size_t iterations = 100000;
+  auto baseline = benchmark::measure(iterations, [text, length]() { return isValidUtf8Bytewise(text, length); });
+  auto optimized = benchmark::measure(iterations, [&view]() { return view.isValidUtf8(); });
+  char title[80];
+  snprintf(title, sizeof(title), "validate %s (byte-wise vs. isValidUtf8)", name);
+  benchmark::report(title, iterations, baseline, optimized);
+
+  baseline = benchmark::measure(iterations, [text, length]() { return countCodePointsBytewise(text, length); });
+  optimized = benchmark::measure(iterations, [&view]() { return view.countCodePoints(); });
+  snprintf(title, sizeof(title), "count code points %s (byte-wise vs. countCodePoints)", name);
+  benchmark::report(title, iterations, baseline, optimized);
+}
+
+static const TestSuite& BenchmarkUtf8 =
+    suite("Benchmark UTF-8")
+        .tests("mostly ASCII", []() {
+            compare("mostly ASCII", MOSTLY_ASCII);
+        })
+        .tests("mixed", []() {
+            compare("mixed", MIXED);
+        });
+
+}
@@ -0,0 +1,131 @@
+#include <yatest.h>
+#include <toolbox/Allocator.h>
+#include <toolbox/String.h>
+
+using namespace yatest;
+
+namespace {
+
+/**
+ * Heap allocator which deterministically refuses blocks of one size.
+ */
+class RefusingAllocator final : public toolbox::IAllocator {
+  toolbox::HeapAllocator _heap;
+  size_t _refusedSize;
+  toolbox::AllocatorStatistics _statistics;
+
+public:
+  explicit RefusingAllocator(size_t refusedSize) : _refusedSize(refusedSize) {}
+
+  void* allocate(size_t size) override {
+    void* block = size != _refusedSize ? _heap.allocate(size) : nullptr;
+    if (block != nullptr) {
+      _statistics.allocated(size);
+    } else {
+      _statistics.failed();
+    }
+    return block;
+  }
+
+  void deallocate(void* block, size_t size) override {
+    _heap.deallocate(block, size);
+    _statistics.deallocated(size);
+  }
+
+  const toolbox::AllocatorStatistics& statistics() const override {
+    return _statistics;
+  }
+};
+
+static const TestSuite& TestAllocator =
+    suite("Allocator")
+        .tests("heap allocator", []() {
+            toolbox::HeapAllocator heap{};
+            void* block = heap.allocate(24);
+            expect::isNotNull(block, "block from heap");
+            expect::equals(heap.statistics().liveBytes, 24u, "live bytes");
+
+            heap.deallocate(block, 24);
+            expect::equals(heap.statistics().liveBlocks, 0u, "no live blocks");
+            expect::equals(heap.statistics().peakBytes, 24u, "peak bytes");
+        })
+        .tests("failing allocations", []() {
+            RefusingAllocator refusing{48};
+            void* block = refusing.allocate(24);
+            expect::isNotNull(block, "other sizes are allocated");
+            expect::isNull(refusing.allocate(48), "refused size fails");
+            expect::equals(refusing.statistics().failedAllocations, 1u, "failed allocations");
+            expect::equals(refusing.statistics().liveBlocks, 1u, "failed allocation is not live");
+            refusing.deallocate(block, 24);
+
+            toolbox::strref input{"request/path/segment"};
+            RefusingAllocator refusingArray{input.length() + 1};
+            expect::isNull(input.toCharArray(true, refusingArray), "failed allocation results in nullptr");
+            expect::equals(refusingArray.statistics().failedAllocations, 1u, "failed allocation counted");
+            expect::equals(refusingArray.statistics().liveBlocks, 0u, "nothing allocated");
+        })
+        .tests("arena allocator", []() {
+            alignas(toolbox::ALLOCATION_ALIGNMENT) char buffer[128];
+            toolbox::ArenaAllocator arena{buffer};
+
+            void* a = arena.allocate(10);
+            void* b = arena.allocate(20);
+            expect::isTrue(a == buffer, "first block at start of buffer");
+            expect::equals(reinterpret_cast<uintptr_t>(b) % toolbox::ALLOCATION_ALIGNMENT, 0u, "blocks are aligned");
+            expect::equals(arena.statistics().liveBlocks, 2u, "live blocks");
+            expect::equals(arena.statistics().liveBytes, 30u, "live bytes");
+            expect::isNull(arena.allocate(200), "allocation exceeding the arena fails");
+            expect::equals(arena.statistics().failedAllocations, 1u, "failed allocations");
+
+            arena.deallocate(a, 10);
+            arena.deallocate(b, 20);
+            expect::equals(arena.statistics().liveBlocks, 0u, "no live blocks");
+            expect::equals(arena.statistics().peakBytes, 30u, "peak bytes");
+            arena.reset();
+            expect::equals(arena.available(), sizeof(buffer), "whole arena available after reset");
+        })
+        .tests("pool allocator", []() {
+            alignas(toolbox::ALLOCATION_ALIGNMENT) char buffer[112];
+            toolbox::PoolAllocator pool{buffer};
+
+            void* a = pool.allocate(10);
+            void* b = pool.allocate(17);
+            expect::isNotNull(a, "small block");
+            expect::isNotNull(b, "medium block");
+            expect::equals(pool.statistics().liveBytes, 48u, "block sizes of size classes");
+            expect::isNull(pool.allocate(toolbox::PoolAllocator::MAX_BLOCK_SIZE + 1), "too large for pool");
+
+            pool.deallocate(a, 10);
+            expect::isTrue(pool.allocate(16) == a, "freed block is reused");
+            expect::isNotNull(pool.allocate(40), "large block from remaining buffer");
+            expect::isNull(pool.allocate(40), "buffer exhausted");
+            expect::equals(pool.statistics().failedAllocations, 2u, "failed allocations");
+        })
+        .tests("shared strings from allocators", []() {
+            alignas(toolbox::ALLOCATION_ALIGNMENT) char buffer[256];
+            toolbox::ArenaAllocator arena{buffer};
+            toolbox::strref input{"request/path/segment"};
+
+            {
+                toolbox::shared_str a = input.skip(8).materialize(arena);
+                expect::equals(strcmp(a.cstr(), "path/segment"), 0, "materialized into arena");
+                expect::isTrue(a.cstr() >= buffer && a.cstr() < buffer + sizeof(buffer), "storage in arena");
+
+                toolbox::AllocatorScope scope{arena};
+                toolbox::strref b = input.leftmost(7).ensure_cstr();
+                expect::equals(strcmp(b.cstr(), "request"), 0, "ensure_cstr in scope");
+                expect::equals(arena.statistics().liveBlocks, 2u, "both strings in arena");
+
+                char* array = input.toCharArray(true, arena);
+                expect::equals(strcmp(array, "request/path/segment"), 0, "char array from arena");
+                arena.deallocate(array, input.length() + 1);
+            }
+            expect::isTrue(&toolbox::defaultAllocator() != &arena, "default allocator restored");
+            expect::equals(arena.statistics().liveBlocks, 0u, "all strings released");
+            arena.reset();
+
+            toolbox::ArenaAllocator tiny{buffer, 8};
+            expect::isTrue(input.materialize(tiny).empty(), "failed allocation results in empty string");
+            expect::equals(tiny.statistics().failedAllocations, 1u, "failed allocation counted");
+        });
+}
@@ -0,0 +1,59 @@
+#include <yatest.h>
+#include <toolbox/String.h>
+
+#ifdef TOOLBOX_ATOMIC_REFCOUNT
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace yatest;
+
+namespace {
+static const TestSuite& TestAtomicRefCount =
+    suite("Atomic reference counting")
+        .tests("share strings between threads", []() {
+            toolbox::shared_str shared = toolbox::strref{"network/worker/shared/payload"}.materialize();
+            const uint32_t expectedHash = toolbox::strref{"network/worker/shared/payload"}.hash();
+
+            std::atomic<bool> wrongHash {false};
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < 4; ++t) {
+                threads.emplace_back([&shared, &wrongHash, expectedHash]() {
+                    for (size_t i = 0; i < 100000; ++i) {
+                        toolbox::strref a{shared};
+                        toolbox::strref slice = a.skip(i % 8);
+                        toolbox::shared_str copy = shared;
+                        if (i % 1000 == 0 && toolbox::strref{copy}.hash() != expectedHash) {
+                            wrongHash = true;
+                            break;
+                        }
+                        slice = a;
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            expect::isFalse(wrongHash, "hash is the same in all threads");
+            expect::equals(shared.useCount(), 1u, "all references released");
+            expect::equals(shared.hash(), expectedHash, "hash");
+        })
+        .tests("release strings in another thread", []() {
+            const size_t liveBlocks = toolbox::defaultAllocator().statistics().liveBlocks;
+            const size_t count = 10000;
+            std::vector<toolbox::strref> strings;
+            strings.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                strings.push_back(toolbox::strref{"message"}.materialize());
+            }
+            std::vector<toolbox::strref> copies = strings;
+
+            std::thread worker([&copies]() { copies.clear(); });
+            strings.clear();
+            worker.join();
+
+            expect::equals(toolbox::defaultAllocator().statistics().liveBlocks, liveBlocks, "all strings released");
+        });
+}
+#endif
@@ -1,5 +1,6 @@
 #include <yatest.h>
 #include <toolbox/Conversion.h>
+#include <string>
 
 using namespace yatest;
 
@@ -32,5 +33,169 @@ static const TestSuite& TestConversion =
             toolbox::Maybe<bool> value = toolbox::convert<bool>::fromString(input, nullptr);
             expect::isTrue(value.available());
             expect::equals(value.get(), true);
+        })
+        .tests("convert integers in all bases", [] () {
+            expect::equals(toolbox::convert<int>::fromString("  -42").get(), -42);
+            expect::equals(toolbox::convert<int>::fromString("+0x1f").get(), 31);
+            expect::equals(toolbox::convert<int>::fromString("017").get(), 15);
+            expect::equals(toolbox::convert<int>::fromString("017", nullptr, 10).get(), 17);
+            expect::equals(toolbox::convert<unsigned int>::fromString("1011", nullptr, 2).get(), 11u);
+            expect::equals(toolbox::convert<unsigned int>::fromString("0X4e20", nullptr, 16).get(), 20000u);
+
+            toolbox::strref next {"INIT"};
+            expect::equals(toolbox::convert<int>::fromString("0x", &next).get(), 0);
+            expect::equals(next, "x");
+            expect::equals(toolbox::convert<int>::fromString("129", &next, 8).get(), 10);
+            expect::equals(next, "9");
+        })
+        .tests("convert integers with exact overflow detection", [] () {
+            expect::equals(toolbox::convert<unsigned char>::fromString("255").get(), (unsigned char) 255);
+            expect::isFalse(toolbox::convert<unsigned char>::fromString("256").available());
+            expect::equals(toolbox::convert<short>::fromString("-32768").get(), (short) -32768);
+            expect::isFalse(toolbox::convert<short>::fromString("-32769").available());
+            expect::isFalse(toolbox::convert<short>::fromString("32768").available());
+            expect::equals(toolbox::convert<int32_t>::fromString("-2147483648").get(), INT32_MIN);
+            expect::isFalse(toolbox::convert<int32_t>::fromString("2147483648").available());
+            expect::equals(toolbox::convert<uint32_t>::fromString("0xFFFFFFFF").get(), UINT32_MAX);
+            expect::isFalse(toolbox::convert<uint32_t>::fromString("0x100000000").available());
+            expect::isFalse(toolbox::convert<unsigned long>::fromString("99999999999999999999999").available());
+            expect::isFalse(toolbox::convert<unsigned int>::fromString("-1").available());
+            expect::equals(toolbox::convert<unsigned int>::fromString("-0").get(), 0u);
+        })
+        .tests("convert integers from views without copying", [] () {
+            toolbox::strref row {FPSTR("12,-345,0x7f")};
+            toolbox::strref next;
+            expect::equals(toolbox::convert<int>::fromString(row.leftmost(2), &next).get(), 12);
+            expect::isTrue(next.empty());
+            expect::equals(toolbox::convert<long>::fromString(row.substring(3, 7), &next).get(), -345L);
+            expect::equals(toolbox::convert<unsigned char>::fromString(row.skip(8), &next).get(), (unsigned char) 127);
+
+            toolbox::shared_str shared {"  987 rest"};
+            expect::equals(toolbox::convert<unsigned short>::fromString(shared, &next).get(), (unsigned short) 987);
+            expect::equals(next, " rest");
+        })
+        .tests("format integers in base 10", [] () {
+            expect::equals(toolbox::convert<int>::toString(0), "0");
+            expect::equals(toolbox::convert<int>::toString(-7), "-7");
+            expect::equals(toolbox::convert<int32_t>::toString(INT32_MIN), "-2147483648");
+            expect::equals(toolbox::convert<uint32_t>::toString(UINT32_MAX), "4294967295");
+            expect::equals(toolbox::convert<unsigned char>::toString(200), "200");
+            expect::equals(toolbox::convert<short>::toString(-32768), "-32768");
+            expect::equals(toolbox::convert<int>::toString(255, 16), "ff");
+
+            char buffer[12] = {};
+            expect::equals(toolbox::convert<unsigned int>::toChars(1000000000u, buffer, sizeof(buffer)), 10u);
+            expect::equals(toolbox::strref{buffer, 10}, "1000000000");
+            expect::equals(toolbox::convert<int>::toChars(-100, buffer, 3), 0u);
+            expect::equals(toolbox::convert<int>::toChars(-100, buffer, 4), 4u);
+            expect::equals(toolbox::strref{buffer, 4}, "-100");
+
+            char output[16] = "n=";
+            toolbox::StringOutput stringOutput {output};
+            expect::equals(toolbox::convert<long>::writeTo(-12345L, stringOutput), 6u);
+            expect::equals(toolbox::strref{output}, "n=-12345");
+
+            for (uint32_t value = 1; value != 0 && value < UINT32_MAX / 3; value = value * 3 + 1) {
+                char expected[12];
+                snprintf(expected, sizeof(expected), "%lu", static_cast<unsigned long>(value));
+                expect::equals(toolbox::convert<uint32_t>::toString(value), toolbox::strref{expected});
+            }
+
+            uint32_t power = 1;
+            for (int digits = 1; digits <= 10; ++digits, power *= 10u) {
+                expect::equals(toolbox::formatting::countDigits(power), digits, "power of ten");
+                expect::equals(toolbox::formatting::countDigits(power - 1u), digits > 1 ? digits - 1 : 1, "below power of ten");
+            }
+            expect::equals(toolbox::formatting::countDigits(UINT32_MAX), 10, "largest 32 bit value");
+        })
+        .tests("convert 64 bit integers", [] () {
+            expect::equals(toolbox::convert<int64_t>::fromString("-9223372036854775808").get(), INT64_MIN);
+            expect::isFalse(toolbox::convert<int64_t>::fromString("9223372036854775808").available());
+            expect::equals(toolbox::convert<uint64_t>::fromString("18446744073709551615").get(), UINT64_MAX);
+            expect::isFalse(toolbox::convert<uint64_t>::fromString("18446744073709551616").available());
+            expect::equals(toolbox::convert<long long>::fromString("0x7fffffffffffffff").get(), INT64_MAX);
+            expect::equals(toolbox::convert<unsigned long long>::fromString("1700000000123").get(), 1700000000123ull);
+
+            toolbox::strref next;
+            toolbox::strref timestamps {FPSTR("1700000000123;1700000000456")};
+            expect::equals(toolbox::convert<long long>::fromString(timestamps, &next).get(), 1700000000123ll);
+            expect::equals(next, ";1700000000456");
+            expect::equals(toolbox::convert<unsigned long long>::fromString("12345678x", &next).get(), 12345678ull);
+            expect::equals(next, "x");
+
+            expect::equals(toolbox::convert<long long>::toString(INT64_MIN), "-9223372036854775808");
+            expect::equals(toolbox::convert<unsigned long long>::toString(UINT64_MAX), "18446744073709551615");
+            expect::equals(toolbox::convert<unsigned long long>::toString(10000000000000000ull), "10000000000000000");
+            expect::equals(toolbox::convert<long long>::toString(-255, 16), "-ff");
+            expect::equals(toolbox::convert<unsigned long long>::toString(5, 2), "101");
+        })
+        .tests("format floating point numbers", [] () {
+            expect::equals(toolbox::convert<double>::toString(0.1), "0.1");
+            expect::equals(toolbox::convert<double>::toString(21.5), "21.5");
+            expect::equals(toolbox::convert<double>::toString(100.0), "100");
+            expect::equals(toolbox::convert<double>::toString(-0.0), "-0");
+            expect::equals(toolbox::convert<double>::toString(0.000001), "0.000001");
+            expect::equals(toolbox::convert<double>::toString(1e-7), "1e-7");
+            expect::equals(toolbox::convert<double>::toString(1e21), "1e+21");
+            expect::equals(toolbox::convert<double>::toString(1.7976931348623157e308), "1.7976931348623157e+308");
+            expect::equals(toolbox::convert<double>::toString(5e-324), "5e-324");
+            expect::equals(toolbox::convert<double>::toString(1.0 / 0.0), "inf");
+            expect::equals(toolbox::convert<double>::toString(-1.0 / 0.0), "-inf");
+            expect::equals(toolbox::convert<float>::toString(0.1f), "0.1");
+            expect::equals(toolbox::convert<float>::toString(21.53f), "21.53");
+            expect::equals(toolbox::convert<float>::toString(3.4028235e38f), "3.4028235e+38");
+
+            char buffer[8];
+            expect::equals(toolbox::convert<double>::toChars(3.25, buffer, sizeof(buffer)), 4u);
+            expect::equals(toolbox::strref{buffer, 4}, "3.25");
+            expect::equals(toolbox::convert<double>::toChars(0.123456789, buffer, sizeof(buffer)), 0u);
+        })
+        .tests("parse floating point numbers", [] () {
+            toolbox::strref next {"INIT"};
+            expect::equals(toolbox::convert<double>::fromString("  -12.5e-1 rest", &next).get(), -1.25);
+            expect::equals(next, " rest");
+            expect::equals(toolbox::convert<double>::fromString(".5").get(), 0.5);
+            expect::equals(toolbox::convert<double>::fromString("1e", &next).get(), 1.0);
+            expect::equals(next, "e");
+            expect::equals(toolbox::convert<double>::fromString("0.1").get(), 0.1);
+            expect::equals(toolbox::convert<double>::fromString("2.2250738585072011e-308").get(), 2.2250738585072011e-308);
+            expect::equals(toolbox::convert<double>::fromString("9007199254740993").get(), 9007199254740992.0);
+            expect::equals(toolbox::convert<double>::fromString("9007199254740993.0000000000000000001").get(), 9007199254740994.0);
+            expect::equals(toolbox::convert<double>::fromString("1e400").get(), 1.0 / 0.0);
+            expect::equals(toolbox::convert<double>::fromString("1e-400").get(), 0.0);
+            expect::equals(toolbox::convert<double>::fromString("-Infinity").get(), -1.0 / 0.0);
+            expect::isTrue(toolbox::convert<double>::fromString("nan").get() != toolbox::convert<double>::fromString("nan").get());
+            expect::isFalse(toolbox::convert<double>::fromString("-.e5").available());
+            expect::equals(toolbox::convert<float>::fromString("3.4028235e38").get(), 3.4028235e38f);
+            expect::equals(toolbox::convert<float>::fromString("1.00000005960464477550").get(), 1.00000012f);
+            expect::equals(toolbox::convert<double>::fromString("1.000000000000000111022302462515654042363166809082031250000001").get(), 1.0000000000000002);
+            expect::equals(toolbox::convert<double>::fromString("1.000000000000000111022302462515654042363166809082031250000000").get(), 1.0);
+            expect::equals(toolbox::convert<float>::fromString("1.000000059604644775390625000000000000000000000000000001").get(), 1.00000012f);
+
+            // The deciding digit after more significant digits than any halfway number has
+            std::string halfway = "1.00000000000000011102230246251565404236316680908203125" + std::string(800, '0');
+            expect::equals(toolbox::convert<double>::fromString(toolbox::strref{halfway.c_str()}).get(), 1.0);
+            halfway += '1';
+            expect::equals(toolbox::convert<double>::fromString(toolbox::strref{halfway.c_str()}).get(), 1.0000000000000002);
+
+            toolbox::strref row {FPSTR("21.53;1013.25")};
+            expect::equals(toolbox::convert<float>::fromString(row.leftmost(5)).get(), 21.53f);
+            expect::equals(toolbox::convert<double>::fromString(row.skip(6)).get(), 1013.25);
+        })
+        .tests("floating point round trip", [] () {
+            uint64_t state = 88172645463325252ull;
+            for (int i = 0; i < 10000; ++i) {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                double value;
+                memcpy(&value, &state, sizeof(value));
+                if (value != value) {
+                    continue;
+                }
+                char buffer[toolbox::formatting::MAX_FLOATING_POINT_LENGTH];
+                size_t length = toolbox::convert<double>::toChars(value, buffer, sizeof(buffer));
+                expect::equals(toolbox::convert<double>::fromString(toolbox::strref{buffer, length}).get(), value);
+            }
         });
-}
+}
\ No newline at end of file
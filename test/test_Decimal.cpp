@@ -18,6 +18,40 @@ static const TestSuite& TestDecimal =
             toolbox::Decimal d1 = toolbox::Decimal::fromFixedPoint(123456789, 8);
             expect::equals(d1.toString(), "1.23456789");
         })
+        .tests("convert fixed point with leading zeros to string", [] () {
+            expect::equals(toolbox::Decimal::fromFixedPoint(5, 2).toString(), "0.05");
+            expect::equals(toolbox::Decimal::fromFixedPoint(-5, 2).toString(), "-0.05");
+            expect::equals(toolbox::Decimal::fromFixedPoint(0, 3).toString(), "0.000");
+            expect::equals(toolbox::Decimal::fromFixedPoint(100, 2).toString(), "1.00");
+            expect::equals(toolbox::Decimal::fromFixedPoint(1, 18).toString(), "0.000000000000000001");
+        })
+        .tests("convert 64 bit fixed point to string", [] () {
+            expect::equals(toolbox::Decimal::fromFixedPoint(INT64_MIN, 0).toString(), "-9223372036854775808");
+            expect::equals(toolbox::Decimal::fromFixedPoint(INT64_MAX, 4).toString(), "922337203685477.5807");
+            expect::equals(toolbox::Decimal::fromFixedPoint(INT64_MIN, 19).toString(), "-0.9223372036854775808");
+            expect::equals(toolbox::Decimal::fromFixedPoint(-1, 19).toString(), "-0.0000000000000000001");
+            expect::equals(toolbox::Decimal::fromFixedPoint(1, 20).toString(), "0.00000000000000000001");
+            expect::isTrue(toolbox::Decimal::fromFixedPoint(1, 21).toString().empty(), "too many decimal places");
+        })
+        .tests("format fixed point into caller buffers", [] () {
+            char buffer1[toolbox::Decimal::MAX_STRING_LENGTH + 1];
+            char buffer2[toolbox::Decimal::MAX_STRING_LENGTH + 1];
+            toolbox::strref s1 = toolbox::Decimal::fromFixedPoint(-4200, 3).toString(buffer1);
+            toolbox::strref s2 = toolbox::Decimal::fromFixedPoint(31415, 4).toString(buffer2);
+            expect::equals(s1, "-4.200", "first buffer is not overwritten");
+            expect::equals(s2, "3.1415");
+
+            char chars[8];
+            expect::equals(toolbox::Decimal::fromFixedPoint(-12345, 2).toChars(chars, sizeof(chars)), size_t(7));
+            expect::equals(toolbox::strref(chars, 7), "-123.45");
+            expect::equals(toolbox::Decimal::fromFixedPoint(-12345, 2).toChars(chars, 6), size_t(0), "buffer too small");
+            expect::equals(toolbox::Decimal::fromFixedPoint(7, 0).toChars(chars, sizeof(chars)), size_t(1), "integer");
+
+            char output[32] {};
+            toolbox::StringOutput stringOutput {output};
+            expect::equals(toolbox::Decimal::fromFixedPoint(-7, 3).writeTo(stringOutput), size_t(6));
+            expect::equals(toolbox::strref{output}, "-0.007");
+        })
         .tests("parse fixed point from string", [] () {
             auto d1 = toolbox::Decimal::fromString("123.45");
             expect::isTrue(d1.available());
@@ -32,6 +66,143 @@ static const TestSuite& TestDecimal =
             auto d1 = toolbox::Decimal::fromString("1.23456789");
             expect::isTrue(d1.available());
             expect::equals(d1.get().toFixedPoint(8), 123456789);
+        })
+        .tests("parse fixed point with decimal places as written", [] () {
+            using toolbox::Decimal;
+            expect::equals(Decimal::fromString("1.50").get().toString(), "1.50");
+            expect::equals(Decimal::fromString("  +0.05").get().toString(), "0.05", "whitespace and sign");
+            expect::equals(Decimal::fromString("-.5").get().toString(), "-0.5");
+            expect::equals(Decimal::fromString("7.").get().toString(), "7");
+            expect::equals(Decimal::fromString("1.5e3").get().toString(), "1500");
+            expect::equals(Decimal::fromString("15E-3").get().toString(), "0.015");
+            expect::equals(Decimal::fromString("-0").get().toString(), "0");
+            expect::equals(Decimal::fromString("0.000000000000000001").get().decimalPlaces(), uint8_t(18));
+            expect::isFalse(Decimal::fromString("0.0000000000000000001").available(), "too many decimal places");
+            expect::isFalse(Decimal::fromString("").available());
+            expect::isFalse(Decimal::fromString("-.").available());
+            expect::isFalse(Decimal::fromString("1.2.3").available(), "trailing characters");
+            expect::isFalse(Decimal::fromString("12 ").available(), "trailing whitespace");
+        })
+        .tests("parse fixed point with exact overflow detection", [] () {
+            using toolbox::Decimal;
+            expect::equals(Decimal::fromString("9223372036854775807").get().toFixedPoint(0), INT64_MAX);
+            expect::equals(Decimal::fromString("-9223372036854775808").get().toFixedPoint(0), INT64_MIN);
+            expect::equals(Decimal::fromString("-922337203685477.5808").get().toString(), "-922337203685477.5808");
+            expect::isFalse(Decimal::fromString("9223372036854775808").available());
+            expect::isFalse(Decimal::fromString("-9223372036854775809").available());
+            expect::isFalse(Decimal::fromString("922337203685477.5808").available());
+            expect::isFalse(Decimal::fromString("12345678901234567890").available());
+            expect::isFalse(Decimal::fromString("1e19").available());
+            expect::equals(Decimal::fromString("0e99999999").get().toFixedPoint(0), int64_t(0));
+        })
+        .tests("parse fixed point rounded to decimal places", [] () {
+            using toolbox::Decimal;
+            expect::equals(Decimal::fromString("1.005", nullptr, 2).get().toString(), "1.01", "half away from zero");
+            expect::equals(Decimal::fromString("-1.005", nullptr, 2).get().toString(), "-1.01");
+            expect::equals(Decimal::fromString("1.00499999", nullptr, 2).get().toString(), "1.00");
+            expect::equals(Decimal::fromString("2.5", nullptr, 0).get().toString(), "3");
+            expect::equals(Decimal::fromString("21", nullptr, 3).get().toString(), "21.000");
+            expect::equals(Decimal::fromString("1.5e-2", nullptr, 2).get().toString(), "0.02");
+            expect::equals(Decimal::fromString("4e-30", nullptr, 2).get().toString(), "0.00");
+            expect::equals(Decimal::fromString("0.0000000000000000001", nullptr, 18).get().toString(), "0.000000000000000000");
+            expect::equals(Decimal::fromString("0.12345678901234567890123", nullptr, 4).get().toString(), "0.1235", "more than 19 digits");
+            expect::equals(Decimal::fromString("1234567890123456789.5", nullptr, 0).get().toFixedPoint(0), int64_t(1234567890123456790));
+            expect::equals(Decimal::fromString("1234567890123456789.4", nullptr, 0).get().toFixedPoint(0), int64_t(1234567890123456789));
+            expect::isFalse(Decimal::fromString("9223372036854775807.5", nullptr, 0).available(), "overflow by rounding");
+            expect::isFalse(Decimal::fromString("10000000", nullptr, 12).available(), "overflow by scale");
+            expect::isFalse(Decimal::fromString("1", nullptr, 19).available());
+        })
+        .tests("parse fixed point from views", [] () {
+            using toolbox::Decimal;
+            toolbox::strref next;
+            toolbox::strref line {"t=-21.50C;p=1.0132e3"};
+            expect::equals(Decimal::fromString(line.skip(2), &next).get().toString(), "-21.50");
+            expect::equals(next, "C;p=1.0132e3");
+            expect::equals(Decimal::fromString(next.skip(4), &next, 1).get().toString(), "1013.2");
+            expect::isTrue(next.empty());
+            expect::equals(Decimal::fromString(line.substring(2, 5)).get().toString(), "-21.5", "slice is not extended");
+            expect::equals(Decimal::fromString(toolbox::strref{"12.5e"}, &next).get().toString(), "12.5", "no exponent digits");
+            expect::equals(next, "e");
+            expect::equals(Decimal::fromString(FPSTR(PSTR("-0.125e1"))).get().toString(), "-1.25", "progmem");
+        });
+
+toolbox::Decimal decimal(const char* string) {
+    return toolbox::Decimal::fromString(string).get();
+}
+
+static const TestSuite& TestDecimalArithmetic =
+    suite("Decimal Arithmetic")
+        .tests("add and subtract", [] () {
+            expect::equals((decimal("1.25") + decimal("2.5")).get().toString(), "3.75");
+            expect::equals((decimal("1.25") - decimal("2.5")).get().toString(), "-1.25");
+            expect::equals((decimal("-7") + decimal("0.001")).get().toString(), "-6.999", "more decimal places");
+            expect::equals((decimal("9223372036854775806") + decimal("1")).get().toFixedPoint(0), INT64_MAX);
+            expect::isFalse((decimal("9223372036854775807") + decimal("1")).available(), "overflow");
+            expect::isFalse((decimal("-9223372036854775808") - decimal("1")).available(), "negative overflow");
+            expect::isFalse((decimal("92233720368547759") + decimal("0.01")).available(), "overflow by scale");
+        })
+        .tests("multiply", [] () {
+            using toolbox::Rounding;
+            expect::equals((decimal("1.25") * decimal("3")).get().toString(), "3.75");
+            expect::equals((decimal("0.2999") * decimal("12.345")).get().toString(), "3.7023", "rounded half even");
+            expect::equals(decimal("0.2999").multiply(decimal("12.345"), 7).get().toString(), "3.7022655", "exact");
+            expect::equals(decimal("0.2999").multiply(decimal("12.345"), 9).get().toString(), "3.702265500", "extended");
+            expect::equals(decimal("2.5").multiply(decimal("0.5"), 1).get().toString(), "1.2", "tie to even");
+            expect::equals(decimal("2.5").multiply(decimal("0.5"), 1, Rounding::HalfUp).get().toString(), "1.3", "tie away from zero");
+            expect::equals(decimal("-2.5").multiply(decimal("0.5"), 1, Rounding::HalfUp).get().toString(), "-1.3");
+            expect::equals(decimal("2.59").multiply(decimal("0.5"), 1, Rounding::Truncate).get().toString(), "1.2", "truncated");
+            expect::equals(decimal("-2.59").multiply(decimal("0.5"), 1, Rounding::Truncate).get().toString(), "-1.2", "truncated towards zero");
+            expect::equals((decimal("1234567.89012345") * decimal("9876.54321")).get().toString(), "12193263112.48278616", "128 bit intermediate");
+            expect::equals((decimal("-4611686018427387904") * decimal("2")).get().toFixedPoint(0), INT64_MIN);
+            expect::isFalse((decimal("4611686018427387904") * decimal("2")).available(), "overflow");
+            expect::isFalse(decimal("1").multiply(decimal("1"), 19).available(), "too many decimal places");
+        })
+        .tests("divide", [] () {
+            using toolbox::Rounding;
+            expect::equals((decimal("10.00") / decimal("4")).get().toString(), "2.50");
+            expect::equals((decimal("10") / decimal("3")).get().toString(), "3");
+            expect::equals(decimal("10").divide(decimal("3"), 6).get().toString(), "3.333333");
+            expect::equals(decimal("-20").divide(decimal("3"), 6).get().toString(), "-6.666667");
+            expect::equals(decimal("1").divide(decimal("0.000000000000000007"), 0).get().toString(), "142857142857142857");
+            expect::equals(decimal("0.5").divide(decimal("2"), 1).get().toString(), "0.2", "tie to even");
+            expect::equals(decimal("0.5").divide(decimal("2"), 1, Rounding::HalfUp).get().toString(), "0.3");
+            expect::equals(decimal("123456789.123456789").divide(decimal("1000000000"), 2).get().toString(), "0.12");
+            expect::isFalse((decimal("1") / decimal("0.00")).available(), "division by zero");
+            expect::isFalse(decimal("1").divide(decimal("0.000000000000000001"), 2).available(), "overflow");
+        })
+        .tests("rescale", [] () {
+            using toolbox::Rounding;
+            expect::equals(decimal("1.2345").rescale(2).get().toString(), "1.23");
+            expect::equals(decimal("1.2350").rescale(2).get().toString(), "1.24", "tie to even (up)");
+            expect::equals(decimal("1.2250").rescale(2).get().toString(), "1.22", "tie to even (down)");
+            expect::equals(decimal("1.2250").rescale(2, Rounding::HalfUp).get().toString(), "1.23");
+            expect::equals(decimal("-1.2299").rescale(2, Rounding::Truncate).get().toString(), "-1.22");
+            expect::equals(decimal("-0.5").rescale(0).get().toString(), "0");
+            expect::equals(decimal("1.5").rescale(4).get().toString(), "1.5000");
+            expect::equals(decimal("9.99999999999999999").rescale(0).get().toString(), "10");
+            expect::isFalse(decimal("10000").rescale(15).available(), "overflow");
+        })
+        .tests("compare", [] () {
+            expect::isTrue(decimal("1.5") == decimal("1.50"));
+            expect::isTrue(decimal("1.5") != decimal("1.51"));
+            expect::isTrue(decimal("-1.5") < decimal("1"));
+            expect::isTrue(decimal("-1.5") < decimal("-1.49"));
+            expect::isTrue(decimal("0") > decimal("-0.000000000000000001"));
+            expect::isTrue(decimal("9223372036854775807") > decimal("0.999999999999999999"), "scaling beyond 64 bits");
+            expect::isTrue(decimal("-9223372036854775808") < decimal("-0.1"));
+            expect::isTrue(decimal("2") >= decimal("2.000"));
+            expect::isTrue(decimal("2") <= decimal("2.001"));
+            expect::isTrue(toolbox::Decimal::fromFixedPoint(1, 0) > toolbox::Decimal::fromFixedPoint(INT64_MAX, 40), "decimal places beyond 19");
+            expect::isTrue(toolbox::Decimal::fromFixedPoint(0, 0) == toolbox::Decimal::fromFixedPoint(0, 40));
+        })
+        .tests("chain results", [] () {
+            toolbox::Maybe<toolbox::Decimal> sum = decimal("0");
+            for (const char* value : {"21.5", "22.25", "20.75", "23"}) {
+                sum = sum + decimal(value);
+            }
+            expect::equals((sum / decimal("4")).get().toString(), "21.88", "average");
+            expect::isFalse((decimal("9223372036854775807") + decimal("1") - decimal("2")).available(), "overflow is kept");
+            expect::isTrue((decimal("1") + decimal("2")) == decimal("3"));
         });
 
 static const TestSuite& TestDecimalHelpers =
@@ -48,5 +219,15 @@ static const TestSuite& TestDecimalHelpers =
             expect::equals(toolbox::numberOfDigits(-1000000), 7, "-1000000 has 7 digits");
             expect::equals(toolbox::numberOfDigits(1000000000), 10, "1000000000 has 10 digits");
             expect::equals(toolbox::numberOfDigits(-1000000000), 10, "-1000000000 has 10 digits");
+            expect::equals(toolbox::numberOfDigits(9999999999LL), 10, "9999999999 has 10 digits");
+            expect::equals(toolbox::numberOfDigits(10000000000LL), 11, "10000000000 has 11 digits");
+            expect::equals(toolbox::numberOfDigits(INT64_MAX), 19, "INT64_MAX has 19 digits");
+            expect::equals(toolbox::numberOfDigits(INT64_MIN), 19, "INT64_MIN has 19 digits");
+        })
+        .tests("power of ten", [] () {
+            expect::equals(toolbox::powerOfTen(0), int64_t(1));
+            expect::equals(toolbox::powerOfTen(9), int64_t(1000000000));
+            expect::equals(toolbox::powerOfTen(18), int64_t(1000000000000000000));
+            expect::equals(toolbox::powerOfTen(19), int64_t(1), "out of range");
         });
 }
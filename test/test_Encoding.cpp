@@ -0,0 +1,224 @@
+#include <yatest.h>
+#include <toolbox/Encoding.h>
+
+using namespace yatest;
+
+namespace {
+
+using namespace toolbox::encoding;
+
+/**
+ * Bytes 0..255 in a scrambled order as test data.
+ */
+void fillBytes(uint8_t* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = uint8_t(i * 167u + 13u);
+  }
+}
+
+std::string referenceHex(const uint8_t* data, size_t size) {
+  std::string result;
+  for (size_t i = 0; i < size; ++i) {
+    result += "0123456789abcdef"[data[i] >> 4];
+    result += "0123456789abcdef"[data[i] & 0x0F];
+  }
+  return result;
+}
+
+std::string referenceBase64(const uint8_t* data, size_t size) {
+  const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string result;
+  for (size_t i = 0; i < size; i += 3) {
+    const uint32_t group = (uint32_t(data[i]) << 16) | (i + 1 < size ? uint32_t(data[i + 1]) << 8 : 0u) | (i + 2 < size ? data[i + 2] : 0u);
+    result += alphabet[group >> 18];
+    result += alphabet[(group >> 12) & 0x3F];
+    result += i + 1 < size ? alphabet[(group >> 6) & 0x3F] : '=';
+    result += i + 2 < size ? alphabet[group & 0x3F] : '=';
+  }
+  return result;
+}
+
+toolbox::strref bytesRef(const uint8_t* data, size_t size) {
+  return toolbox::strref{reinterpret_cast<const char*>(data), size};
+}
+
+static const TestSuite& TestEncoding =
+    suite("Encoding")
+        .tests("hex", []() {
+            uint8_t data[70];
+            fillBytes(data, sizeof(data));
+            char chars[2 * sizeof(data)];
+            uint8_t decoded[sizeof(data)];
+            for (size_t size = 0; size <= sizeof(data); ++size) {
+                const std::string expected = referenceHex(data, size);
+                expect::equals(encodeHex(bytesRef(data, size), chars, sizeof(chars)), hexLength(size), "encoded length");
+                expect::equals(std::string(chars, hexLength(size)), expected, "encoded");
+                expect::equals(decodeHex(toolbox::strref{chars, hexLength(size)}, decoded, sizeof(decoded)).get(), size, "decoded length");
+                expect::isTrue(memcmp(decoded, data, size) == 0, "decoded");
+            }
+
+            const uint8_t bytes[] = {0xDE, 0xAD, 0xBE, 0xEF, 0x01};
+            expect::equals(encodeHex(bytesRef(bytes, 5), chars, sizeof(chars), true), size_t(10));
+            expect::equals(std::string(chars, 10), "DEADBEEF01", "upper case");
+            expect::equals(encodeHex(bytesRef(bytes, 5), chars, 9), size_t(0), "buffer too small");
+            expect::equals(decodeHex("DeadBeef01", decoded, sizeof(decoded)).get(), size_t(5), "mixed case");
+            expect::isTrue(memcmp(decoded, bytes, 5) == 0, "mixed case bytes");
+            expect::equals(decodeHex(FPSTR(PSTR("00112233445566778899aabbccddeeff0011223344556677")), decoded, sizeof(decoded)).get(), size_t(24), "progmem");
+            expect::equals(decoded[23], uint8_t(0x77));
+
+            expect::isFalse(decodeHex("abc", decoded, sizeof(decoded)).available(), "odd length");
+            expect::isFalse(decodeHex("0123456g", decoded, sizeof(decoded)).available(), "invalid character in word");
+            expect::isFalse(decodeHex("0g", decoded, sizeof(decoded)).available(), "invalid character");
+            expect::isFalse(decodeHex("01:2", decoded, sizeof(decoded)).available(), "invalid character next to digits");
+            expect::isFalse(decodeHex("0011", decoded, 1).available(), "buffer too small");
+        })
+        .tests("base64", []() {
+            expect::equals(encodeBase64("", nullptr, 0), size_t(0));
+            const char* inputs[] = {"f", "fo", "foo", "foob", "fooba", "foobar"};
+            const char* outputs[] = {"Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+            char chars[128];
+            uint8_t decoded[96];
+            for (size_t i = 0; i < 6; ++i) {
+                const size_t length = encodeBase64(inputs[i], chars, sizeof(chars));
+                expect::equals(std::string(chars, length), outputs[i], inputs[i]);
+                expect::equals(decodeBase64(outputs[i], decoded, sizeof(decoded)).get(), strlen(inputs[i]), outputs[i]);
+                expect::isTrue(memcmp(decoded, inputs[i], strlen(inputs[i])) == 0, outputs[i]);
+            }
+
+            uint8_t data[70];
+            fillBytes(data, sizeof(data));
+            for (size_t size = 0; size <= sizeof(data); ++size) {
+                const std::string expected = referenceBase64(data, size);
+                expect::equals(encodeBase64(bytesRef(data, size), chars, sizeof(chars)), base64Length(size), "encoded length");
+                expect::equals(std::string(chars, base64Length(size)), expected, "encoded");
+                expect::equals(decodeBase64(toolbox::strref{chars, base64Length(size)}, decoded, sizeof(decoded)).get(), size, "decoded length");
+                expect::isTrue(memcmp(decoded, data, size) == 0, "decoded");
+            }
+
+            expect::equals(decodeBase64("Zm9vYmE", decoded, sizeof(decoded)).get(), size_t(5), "without padding");
+            expect::equals(decodeBase64(FPSTR(PSTR("VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZw==")), decoded, sizeof(decoded)).get(), size_t(43), "progmem");
+            expect::isTrue(memcmp(decoded, "The quick brown fox jumps over the lazy dog", 43) == 0, "progmem bytes");
+            expect::equals(encodeBase64(FPSTR(PSTR("The quick brown fox jumps over the lazy dog")), chars, sizeof(chars)), size_t(60), "progmem encoded");
+            expect::equals(std::string(chars, 60), "VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZw==");
+
+            expect::isFalse(decodeBase64("Zm9vY", decoded, sizeof(decoded)).available(), "single character in last group");
+            expect::isFalse(decodeBase64("Zm9v=mFy", decoded, sizeof(decoded)).available(), "padding inside");
+            expect::isFalse(decodeBase64("Zm9vYm-y", decoded, sizeof(decoded)).available(), "invalid character");
+            expect::isFalse(decodeBase64("Zm9vYm\xC6y", decoded, sizeof(decoded)).available(), "non-ASCII character");
+            expect::isFalse(decodeBase64("Z===", decoded, sizeof(decoded)).available(), "too much padding");
+            expect::isFalse(decodeBase64("Zm9vYmFy", decoded, 5).available(), "buffer too small");
+            expect::equals(encodeBase64("foo", chars, 3), size_t(0), "encoding buffer too small");
+        })
+        .tests("encoding outputs", []() {
+            uint8_t data[100];
+            fillBytes(data, sizeof(data));
+            for (size_t chunk : {1u, 2u, 3u, 5u, 31u, 100u}) {
+                char hex[256] {};
+                toolbox::StringOutput hexTarget {hex};
+                toolbox::HexOutput hexOutput {hexTarget};
+                char base64[256] {};
+                toolbox::StringOutput base64Target {base64};
+                toolbox::Base64Output base64Output {base64Target};
+                for (size_t offset = 0; offset < sizeof(data); offset += chunk) {
+                    const size_t size = std::min(chunk, sizeof(data) - offset);
+                    expect::equals(hexOutput.write(bytesRef(data + offset, size)), size, "hex bytes written");
+                    expect::equals(base64Output.write(bytesRef(data + offset, size)), size, "base64 bytes written");
+                }
+                base64Output.finish();
+                expect::equals(std::string(hex), referenceHex(data, sizeof(data)), "hex");
+                expect::equals(std::string(base64), referenceBase64(data, sizeof(data)), "base64");
+            }
+
+            char base64[16] {};
+            toolbox::StringOutput target {base64};
+            toolbox::Base64Output output {target};
+            output.write('f');
+            output.write('o');
+            expect::equals(std::string(base64), "", "incomplete group is kept");
+            expect::equals(output.finish(), size_t(4));
+            expect::equals(std::string(base64), "Zm8=");
+            expect::equals(output.finish(), size_t(0), "nothing left");
+
+            char small[7] {};
+            toolbox::StringOutput smallTarget {small};
+            toolbox::HexOutput hexOutput {smallTarget};
+            expect::equals(hexOutput.write(bytesRef(data, 4)), size_t(3), "bytes written completely");
+        })
+        .tests("decoding inputs", []() {
+            uint8_t data[100];
+            fillBytes(data, sizeof(data));
+            const std::string hex = referenceHex(data, sizeof(data));
+            const std::string base64 = referenceBase64(data, sizeof(data));
+            for (size_t chunk : {1u, 2u, 3u, 4u, 7u, 64u, 200u}) {
+                toolbox::StringInput hexSource {hex.c_str()};
+                toolbox::HexInput hexInput {hexSource};
+                toolbox::StringInput base64Source {base64.c_str()};
+                toolbox::Base64Input base64Input {base64Source};
+                char hexDecoded[100];
+                char base64Decoded[100];
+                size_t hexLength = 0;
+                size_t base64Length = 0;
+                expect::equals(base64Input.available(), sizeof(data) + 2u, "available, including padding not read yet");
+                while (hexInput.available()) {
+                    hexLength += hexInput.read(hexDecoded + hexLength, std::min(chunk, sizeof(hexDecoded) - hexLength));
+                }
+                while (base64Input.available()) {
+                    base64Length += base64Input.read(base64Decoded + base64Length, std::min(chunk, sizeof(base64Decoded) - base64Length));
+                }
+                expect::equals(hexLength, sizeof(data), "hex length");
+                expect::isTrue(memcmp(hexDecoded, data, sizeof(data)) == 0, "hex");
+                expect::isFalse(hexInput.failed());
+                expect::equals(base64Length, sizeof(data), "base64 length");
+                expect::isTrue(memcmp(base64Decoded, data, sizeof(data)) == 0, "base64");
+                expect::isFalse(base64Input.failed());
+            }
+
+            char buffer[16];
+            toolbox::StringInput unpadded {"Zm9vYmE"};
+            toolbox::Base64Input unpaddedInput {unpadded};
+            expect::equals(unpaddedInput.readString(buffer, sizeof(buffer)), size_t(5), "without padding");
+            expect::equals(std::string(buffer), "fooba");
+
+            toolbox::StringInput progmem {FPSTR(PSTR("Zm9vYg=="))};
+            toolbox::Base64Input progmemInput {progmem};
+            expect::equals(progmemInput.readString(buffer, sizeof(buffer)), size_t(4), "progmem");
+            expect::equals(std::string(buffer), "foob");
+
+            toolbox::StringInput invalid {"Zm9v!mFy"};
+            toolbox::Base64Input invalidInput {invalid};
+            expect::equals(invalidInput.read(buffer, sizeof(buffer)), size_t(3), "up to invalid group");
+            expect::isTrue(invalidInput.failed());
+            expect::equals(invalidInput.available(), size_t(0));
+
+            toolbox::StringInput trailing {"Zg==Zg=="};
+            toolbox::Base64Input trailingInput {trailing};
+            trailingInput.read(buffer, sizeof(buffer));
+            expect::isTrue(trailingInput.failed(), "data after padding");
+
+            char large[48];
+            const std::string longTrailing = "Zg==" + std::string(44, 'Q');
+            toolbox::StringInput longTrailingSource {longTrailing.c_str()};
+            toolbox::Base64Input longTrailingInput {longTrailingSource};
+            expect::equals(longTrailingInput.read(large, sizeof(large)), size_t(1), "long data after padding");
+            expect::isTrue(longTrailingInput.failed());
+            expect::equals(longTrailingInput.available(), size_t(0));
+
+            const std::string longInvalid = "Zm9v!mFy" + std::string(40, 'Q');
+            toolbox::StringInput longInvalidSource {longInvalid.c_str()};
+            toolbox::Base64Input longInvalidInput {longInvalidSource};
+            expect::equals(longInvalidInput.read(large, sizeof(large)), size_t(3), "long input with invalid group");
+            expect::isTrue(longInvalidInput.failed());
+            expect::equals(longInvalidInput.read(large, sizeof(large)), size_t(0), "nothing after failure");
+
+            toolbox::StringInput odd {"0a1"};
+            toolbox::HexInput oddInput {odd};
+            expect::equals(oddInput.read(buffer, sizeof(buffer)), size_t(1), "odd length");
+            expect::isTrue(oddInput.failed());
+
+            toolbox::StringInput invalidHex {"0a1x22"};
+            toolbox::HexInput invalidHexInput {invalidHex};
+            expect::equals(invalidHexInput.read(buffer, sizeof(buffer)), size_t(1), "invalid hex");
+            expect::isTrue(invalidHexInput.failed());
+        });
+
+}
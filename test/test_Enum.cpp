@@ -0,0 +1,101 @@
+#include <yatest.h>
+#include <toolbox/Enum.h>
+
+using namespace yatest;
+
+namespace {
+
+enum struct Command : uint8_t {
+  Start,
+  Stop,
+  Reset,
+  Status,
+  Unnamed
+};
+
+enum struct Level : int8_t {
+  Off = -1,
+  Low = 1,
+  High = 2
+};
+
+}
+
+template<>
+struct toolbox::enum_names<Command> {
+  static constexpr toolbox::enum_name<Command> entries[] = {
+    {Command::Start, "start"},
+    {Command::Stop, "stop"},
+    {Command::Reset, "reset"},
+    {Command::Status, "status"},
+    {Command::Start, "go"},
+  };
+};
+
+template<>
+struct toolbox::enum_names<Level> {
+  static constexpr toolbox::enum_name<Level> entries[] = {
+    {Level::Off, "OFF"},
+    {Level::Low, "LOW"},
+    {Level::High, "HIGH"},
+  };
+};
+
+namespace {
+
+static const TestSuite& TestEnum =
+    suite("Enum")
+        .tests("enum names from string", []() {
+            using toolbox::convert;
+            expect::equals(uint8_t(convert<Command>::fromString("start").get()), uint8_t(Command::Start), "start");
+            expect::equals(uint8_t(convert<Command>::fromString("status").get()), uint8_t(Command::Status), "status");
+            expect::equals(uint8_t(convert<Command>::fromString("go").get()), uint8_t(Command::Start), "alias");
+            expect::equals(uint8_t(convert<Command>::fromString(FPSTR(PSTR("reset"))).get()), uint8_t(Command::Reset), "progmem");
+            expect::equals(int8_t(convert<Level>::fromString("OFF").get()), int8_t(Level::Off), "negative value");
+
+            expect::isFalse(convert<Command>::fromString("").available(), "empty");
+            expect::isFalse(convert<Command>::fromString("sta").available(), "prefix of a name");
+            expect::isFalse(convert<Command>::fromString("starting").available(), "longer than a name");
+            expect::isFalse(convert<Command>::fromString("START").available(), "case sensitive");
+            expect::isFalse(convert<Level>::fromString("MEDIUM").available(), "unknown name");
+        })
+        .tests("enum names in views", []() {
+            using toolbox::convert;
+            toolbox::strref next;
+            toolbox::strref line {"  stop,reset 5"};
+            expect::equals(uint8_t(convert<Command>::fromString(line, &next).get()), uint8_t(Command::Stop));
+            expect::equals(next, ",reset 5");
+            expect::equals(uint8_t(convert<Command>::fromString(next.skip(1), &next).get()), uint8_t(Command::Reset));
+            expect::equals(next, " 5");
+            expect::isFalse(convert<Command>::fromString(line.substring(2, 3)).available(), "slice is not extended");
+
+            toolbox::shared_str shared {"status"};
+            expect::equals(uint8_t(convert<Command>::fromString(shared).get()), uint8_t(Command::Status), "shared_str");
+        })
+        .tests("enum names to string", []() {
+            using toolbox::convert;
+            expect::equals(convert<Command>::toString(Command::Start), "start", "first name of alias");
+            expect::equals(convert<Command>::toString(Command::Status), "status");
+            expect::isTrue(convert<Command>::toString(Command::Stop).isInProgmem(), "names in progmem");
+            expect::isTrue(convert<Command>::toString(Command::Unnamed).empty(), "no name");
+            expect::equals(convert<Level>::toString(Level::Off), "OFF");
+            expect::equals(convert<Level>::toString(Level::High), "HIGH");
+            expect::isTrue(convert<Level>::toString(Level(0)).empty(), "gap");
+            expect::isTrue(convert<Level>::toString(Level(7)).empty(), "out of range");
+            expect::isTrue(convert<Command>::toString(Command::Reset).isZeroTerminated(), "zero-terminated");
+
+            char buffer[8] {};
+            toolbox::StringOutput output {buffer};
+            expect::equals(convert<Level>::writeTo(Level::Low, output), size_t(3));
+            expect::equals(toolbox::strref{buffer}, "LOW");
+        })
+        .tests("enum tables", []() {
+            static_assert(toolbox::enum_table<Command>::size() == 5u, "all entries");
+            static_assert(toolbox::keywords::findPerfectHash<Command>().bits >= 3u, "at least one slot per name");
+            for (const auto& entry : toolbox::enum_names<Command>::entries) {
+                toolbox::ram_strref name {entry.name, strlen(entry.name)};
+                expect::equals(uint8_t(toolbox::enum_table<Command>::find(name).get()), uint8_t(entry.value), entry.name);
+            }
+        });
+
+}
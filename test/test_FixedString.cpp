@@ -0,0 +1,52 @@
+#include <yatest.h>
+#include <toolbox/FixedString.h>
+
+using namespace yatest;
+
+namespace {
+static const TestSuite& TestFixedString =
+    suite("FixedString")
+        .tests("append and convert to strref", []() {
+            toolbox::FixedString<32> topic;
+            expect::equals(topic.capacity(), 32u, "capacity");
+            expect::isTrue(topic.empty(), "initially empty");
+
+            topic.append("sensors/").append(FPSTR(PSTR("node-"))).append(42).append('/').append(0xbeefu, 16);
+            expect::equals(topic.length(), 20u, "length");
+            expect::isFalse(topic.isTruncated(), "not truncated");
+            expect::equals(strcmp(topic.cstr(), "sensors/node-42/beef"), 0, "contents");
+
+            toolbox::strref ref = topic;
+            expect::equals(ref.length(), 20u, "strref length");
+            expect::isTrue(ref.isZeroTerminated(), "strref zero terminated");
+            expect::equals(ref, "sensors/node-42/beef", "strref contents");
+
+            topic = toolbox::strref{"reset"};
+            expect::equals(topic.length(), 5u, "length after assignment");
+            expect::equals(toolbox::strref{topic}, "reset", "contents after assignment");
+        })
+        .tests("appendf", []() {
+            toolbox::FixedString<16> value;
+            value.appendf("%d.%02d", 21, 5).appendf(FPSTR(PSTR(" %s")), "C");
+            expect::equals(toolbox::strref{value}, "21.05 C", "formatted contents");
+            expect::equals(value.length(), 7u, "formatted length");
+            expect::isFalse(value.isTruncated(), "not truncated");
+
+            value.appendf("%s", "too long for the rest");
+            expect::isTrue(value.isTruncated(), "truncated");
+            expect::equals(value.length(), 16u, "length limited to capacity");
+            expect::equals(strlen(value.cstr()), 16u, "zero-terminated at capacity");
+        })
+        .tests("truncation", []() {
+            toolbox::FixedString<4> id;
+            id.append("abc").append(true);
+            expect::isTrue(id.isTruncated(), "truncated");
+            expect::equals(toolbox::strref{id}, "abct", "kept contents up to capacity");
+            id.append('x');
+            expect::equals(id.length(), 4u, "length stays at capacity");
+
+            id.clear();
+            expect::isFalse(id.isTruncated(), "clear resets truncation");
+            expect::isTrue(id.empty(), "clear empties");
+        });
+}
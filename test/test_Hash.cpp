@@ -0,0 +1,43 @@
+#include <yatest.h>
+#include <toolbox/Hash.h>
+#include <toolbox/String.h>
+
+using namespace yatest;
+
+namespace {
+static const TestSuite& TestHash =
+    suite("Hash")
+        .tests("hash32 reference values", []() {
+            expect::equals(toolbox::hash32("", 0), 0x00000000u, "empty");
+            expect::equals(toolbox::hash32("hello", 5), 0x248bfa47u, "hello");
+            expect::equals(toolbox::hash32("Hello, world!", 13), 0xc0363e43u, "Hello, world!");
+            expect::equals(toolbox::hash32("The quick brown fox jumps over the lazy dog", 43), 0x2e4ff723u, "quick brown fox");
+            static_assert(toolbox::hash32("hello", 5) == 0x248bfa47u, "hash32 is usable at compile time");
+        })
+        .tests("hash32_P matches hash32", []() {
+            static const char text[] PROGMEM = "abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-_";
+            for (size_t length = 0; length <= strlen(text); ++length) {
+                expect::equals(toolbox::hash32_P(text, length), toolbox::hash32(text, length), "same hash for all lengths");
+            }
+        })
+        .tests("strref hash is independent of the type", []() {
+            using namespace toolbox::literals;
+            toolbox::strref a{"sensor/temperature"};
+            toolbox::strref b{FPSTR(PSTR("sensor/temperature"))};
+            String string{"sensor/temperature"};
+            toolbox::strref c{string};
+            toolbox::shared_str shared = a.materialize();
+            toolbox::strref d{shared};
+            constexpr uint32_t expected = "sensor/temperature"_sr.hash();
+
+            expect::equals(a.hash(), expected, "const char hash");
+            expect::equals(b.hash(), expected, "progmem hash");
+            expect::equals(c.hash(), expected, "String hash");
+            expect::equals(d.hash(), expected, "shared_str strref hash");
+            expect::equals(shared.hash(), expected, "shared_str hash");
+            expect::equals(shared.hash(), expected, "cached shared_str hash");
+            expect::equals(d.skip(7).hash(), toolbox::strref{"temperature"}.hash(), "partial shared_str hash");
+            expect::equals(TOOLBOX_FSTR("sensor/temperature").hash(), expected, "progmem literal hash");
+            expect::isFalse(a.hash() == toolbox::strref{"sensor/temperaturE"}.hash(), "different contents");
+        });
+}
@@ -0,0 +1,82 @@
+#include <yatest.h>
+#include <toolbox/InternTable.h>
+
+using namespace yatest;
+
+namespace {
+static const TestSuite& TestInternTable =
+    suite("InternTable")
+        .tests("intern equal strings to the same storage", []() {
+            toolbox::InternTable<8> table{};
+            expect::equals(table.capacity(), 8u, "capacity");
+            expect::equals(table.size(), 0u, "initial size");
+
+            toolbox::strref input{"sensors/kitchen/temperature"};
+            toolbox::shared_str a = table.intern(input.leftmost(7));
+            toolbox::shared_str b = table.intern(FPSTR(PSTR("sensors")));
+            toolbox::shared_str c = table.intern("kitchen");
+            expect::isTrue(a.sharesStorageWith(b), "same contents share storage");
+            expect::isFalse(a.sharesStorageWith(c), "different contents");
+            expect::equals(strcmp(b.cstr(), "sensors"), 0, "interned contents");
+            expect::equals(table.size(), 2u, "size");
+            expect::isTrue(table.contains("kitchen"), "contains");
+            expect::isFalse(table.contains("temperature"), "does not contain");
+            expect::isTrue(table.intern("").empty(), "empty string is not interned");
+
+            const toolbox::InternStatistics& statistics = table.statistics();
+            expect::equals(statistics.lookups, 3u, "lookups");
+            expect::equals(statistics.hits, 1u, "hits");
+            expect::equals(statistics.bytesSaved, 7u, "bytes saved");
+            expect::isTrue(statistics.hitRate() > 0.33f && statistics.hitRate() < 0.34f, "hit rate");
+        })
+        .tests("evict unused entries when full", []() {
+            toolbox::InternTable<3> table{};
+            toolbox::shared_str kept = table.intern("kept");
+            table.intern("a");
+            table.intern("b");
+            expect::equals(table.size(), 3u, "full");
+
+            toolbox::shared_str c = table.intern("c");
+            expect::equals(table.statistics().evictions, 2u, "unused entries evicted");
+            expect::equals(table.size(), 2u, "size after eviction");
+            expect::isTrue(table.intern("kept").sharesStorageWith(kept), "used entry kept");
+            expect::isTrue(table.intern("c").sharesStorageWith(c), "new entry interned");
+
+            toolbox::shared_str d = table.intern("d");
+            toolbox::shared_str e = table.intern("e");
+            expect::equals(table.statistics().rejections, 1u, "rejected when nothing can be evicted");
+            expect::equals(strcmp(e.cstr(), "e"), 0, "rejected string is still materialized");
+            expect::isFalse(table.contains("e"), "rejected string is not interned");
+
+            table.clear();
+            expect::equals(table.size(), 0u, "size after clear");
+            expect::equals(kept.useCount(), 1u, "table released entries");
+        })
+        .tests("keep colliding entries reachable when purging", []() {
+            toolbox::InternTable<7> table{};
+            toolbox::shared_str kept[4];
+            const char* names[] = {"alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta"};
+            for (size_t i = 0; i < 7; ++i) {
+                toolbox::shared_str interned = table.intern(names[i]);
+                if (i % 2 == 1u || i == 6u) {
+                    kept[i / 2] = interned;
+                }
+            }
+            expect::equals(table.size(), 7u, "full");
+            expect::equals(table.purge(), 3u, "unused entries evicted");
+            expect::equals(table.size(), 4u, "size after purge");
+            for (size_t i = 0; i < 7; ++i) {
+                expect::equals(table.contains(names[i]), i % 2 == 1u || i == 6u, names[i]);
+            }
+            expect::isTrue(table.intern("eta").sharesStorageWith(kept[3]), "entry still found");
+        })
+        .tests("reject strings when the allocator fails", []() {
+            toolbox::InternTable<4> table{};
+            alignas(toolbox::ALLOCATION_ALIGNMENT) char buffer[8];
+            toolbox::ArenaAllocator arena{buffer};
+            toolbox::AllocatorScope scope{arena};
+            expect::isTrue(table.intern("does not fit").empty(), "nothing materialized");
+            expect::equals(table.size(), 0u, "nothing inserted");
+            expect::equals(table.statistics().rejections, 1u, "counted as rejection");
+        });
+}
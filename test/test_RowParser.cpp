@@ -0,0 +1,92 @@
+#include <yatest.h>
+#include <toolbox/RowParser.h>
+
+using namespace yatest;
+
+namespace {
+static const TestSuite& TestRowParser =
+    suite("RowParser")
+        .tests("parse integer rows", [] () {
+            toolbox::strref input {"12,345,-7,88\n1,2,3,4\r\n"};
+            toolbox::strref rest;
+            int values[4] = {};
+            toolbox::FieldStatus status[4];
+
+            expect::equals(toolbox::parseRow(input, ',', values, status, &rest), 4u);
+            expect::equals(values[0], 12);
+            expect::equals(values[1], 345);
+            expect::equals(values[2], -7);
+            expect::equals(values[3], 88);
+            expect::isTrue(status[3].error == toolbox::FieldError::None);
+            expect::equals(status[3].position, 12u);
+            expect::equals(rest, "1,2,3,4\r\n");
+
+            expect::equals(toolbox::parseRow(rest, ',', values, status, &rest), 4u);
+            expect::equals(values[3], 4);
+            expect::isTrue(status[3].error == toolbox::FieldError::None, "carriage return is not part of the row");
+            expect::isTrue(rest.empty());
+        })
+        .tests("report errors per field", [] () {
+            int16_t values[6] = {-1, -1, -1, -1, -1, -1};
+            toolbox::FieldStatus status[6];
+            expect::equals(toolbox::parseRow(toolbox::strref{" 1 ,,x,40000,5a"}, ',', values, status), 1u);
+            expect::equals(values[0], int16_t(1));
+            expect::isTrue(status[0].error == toolbox::FieldError::None);
+            expect::isTrue(status[1].error == toolbox::FieldError::Empty);
+            expect::equals(status[1].position, 4u);
+            expect::isTrue(status[2].error == toolbox::FieldError::Invalid);
+            expect::equals(status[2].position, 5u);
+            expect::isTrue(status[3].error == toolbox::FieldError::Invalid, "overflow");
+            expect::isTrue(status[4].error == toolbox::FieldError::Trailing);
+            expect::equals(status[4].position, 14u);
+            expect::isTrue(status[5].error == toolbox::FieldError::Missing);
+            expect::equals(values[2], int16_t(-1), "invalid fields are unchanged");
+
+            uint16_t unsignedValues[4] = {};
+            expect::equals(toolbox::parseRow(toolbox::strref{"-0,-5,65535,65536"}, ',', unsignedValues, status), 2u);
+            expect::isTrue(status[1].error == toolbox::FieldError::Invalid, "negative unsigned");
+            expect::equals(unsignedValues[2], uint16_t(65535));
+            expect::isTrue(status[3].error == toolbox::FieldError::Invalid, "unsigned overflow");
+        })
+        .tests("parse rows from PROGMEM", [] () {
+            toolbox::strref input {FPSTR(" 7 ;x;-3\r\n1;2;3;4;5\n")};
+            toolbox::strref rest;
+            int values[4] = {};
+            toolbox::FieldStatus status[4];
+
+            expect::equals(toolbox::parseRow(input, ';', values, status, &rest), 2u);
+            expect::equals(values[0], 7);
+            expect::isTrue(status[1].error == toolbox::FieldError::Invalid);
+            expect::equals(status[1].position, 4u);
+            expect::equals(values[2], -3);
+            expect::isTrue(status[3].error == toolbox::FieldError::Missing);
+            expect::equals(status[3].position, 8u);
+            expect::equals(rest, "1;2;3;4;5\n");
+
+            expect::equals(toolbox::parseRow(rest, ';', values, status, &rest), 4u, "further fields are skipped");
+            expect::equals(values[3], 4);
+            expect::isTrue(rest.empty());
+        })
+        .tests("parse other types", [] () {
+            bool flags[4] = {};
+            expect::equals(toolbox::parseRow(toolbox::strref{FPSTR("1;false;true;0")}, ';', flags), 4u);
+            expect::isTrue(flags[0]);
+            expect::isFalse(flags[1]);
+            expect::isTrue(flags[2]);
+            expect::isFalse(flags[3]);
+
+            toolbox::Decimal decimals[3];
+            expect::equals(toolbox::parseRow(toolbox::strref{"21.53 -0.5 1013"}, ' ', decimals), 3u);
+            expect::equals(decimals[0].toFixedPoint(2), 2153);
+            expect::equals(decimals[1].toFixedPoint(1), -5);
+            expect::equals(decimals[2].toFixedPoint(0), 1013);
+            expect::equals(toolbox::parseRow(toolbox::strref{"1.5e2;-2.5E-3"}, ';', decimals), 2u);
+            expect::equals(decimals[0].toFixedPoint(0), 150, "exponent");
+            expect::equals(decimals[1].toFixedPoint(4), -25, "negative exponent");
+
+            double doubles[2] = {};
+            expect::equals(toolbox::parseRow(toolbox::strref{"1.5e3\t,-0.25"}, ',', doubles), 2u);
+            expect::equals(doubles[0], 1500.0);
+            expect::equals(doubles[1], -0.25);
+        });
+}
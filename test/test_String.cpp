@@ -5,6 +5,36 @@
 
 using namespace yatest;
 
+namespace {
+
+/**
+ * Heap allocator counting the allocations made through it, to check which operations
+ * allocate (when set as default allocator).
+ */
+class CountingAllocator final : public toolbox::IAllocator {
+  toolbox::HeapAllocator _heap;
+
+public:
+  size_t allocations = 0;
+
+  void* allocate(size_t size) override {
+    ++allocations;
+    return _heap.allocate(size);
+  }
+
+  void deallocate(void* block, size_t size) override {
+    _heap.deallocate(block, size);
+  }
+
+  const toolbox::AllocatorStatistics& statistics() const override {
+    return _heap.statistics();
+  }
+};
+
+CountingAllocator countingAllocator;
+
+}
+
 namespace {
 static const TestSuite& TestString =
     suite("String")
@@ -120,5 +150,279 @@ static const TestSuite& TestString =
             expect::isFalse(g.empty(), "copy not empty");
             expect::equals(g.length(), 6u, "copy length");
             expect::equals(strcmp(g.cstr(), "abcdef"), 0, "copy contents");
+        })
+        .tests("shared strref copies and slices do not allocate", []() {
+            toolbox::AllocatorScope scope{countingAllocator};
+            toolbox::shared_str shared = toolbox::strref{"topic/segment/value"}.materialize();
+            toolbox::strref a{shared};
+            expect::isTrue(a.type() == toolbox::strref::Type::SharedStr, "shared type");
+
+            const size_t allocationsBefore = countingAllocator.allocations;
+            for (size_t i = 0; i < 1000; ++i) {
+                toolbox::strref slice = a.substring(i % 6, 5);
+                toolbox::strref copy = slice;
+                copy = a.skip(6);
+                toolbox::strref moved = static_cast<toolbox::strref&&>(copy);
+                expect::equals(moved.length(), 13u, "slice length");
+            }
+            expect::equals(countingAllocator.allocations, allocationsBefore, "no allocations for slices");
+
+            toolbox::strref slice = a.skip(6).leftmost(7);
+            a = toolbox::strref{};
+            shared.clear();
+            expect::equals(slice, "segment", "slice keeps storage alive");
+            expect::isTrue(slice.materialize().length() == 7u, "materialize slice");
+
+            toolbox::strref empty{toolbox::shared_str{}};
+            expect::isTrue(empty.empty(), "empty shared_str");
+            expect::equals(empty, "", "empty shared_str contents");
+        })
+        .tests("materialize allocates a single block", []() {
+            toolbox::AllocatorScope scope{countingAllocator};
+            toolbox::strref shortString{"unit"};
+            toolbox::strref longString{"a/rather/long/topic/path/exceeding/the/short/capacity"};
+
+            size_t allocationsBefore = countingAllocator.allocations;
+            toolbox::shared_str a = shortString.materialize();
+            expect::equals(countingAllocator.allocations - allocationsBefore, 1u, "short string allocations");
+            expect::equals(strcmp(a.cstr(), "unit"), 0, "short string contents");
+
+            allocationsBefore = countingAllocator.allocations;
+            toolbox::shared_str b = longString.materialize();
+            expect::equals(countingAllocator.allocations - allocationsBefore, 1u, "long string allocations");
+            expect::equals(b.length(), longString.length(), "long string length");
+            expect::isTrue(longString == b, "long string contents");
+
+            allocationsBefore = countingAllocator.allocations;
+            toolbox::strref c = longString.leftmost(3).ensure_cstr();
+            expect::equals(countingAllocator.allocations - allocationsBefore, 1u, "ensure_cstr allocations");
+            expect::equals(strcmp(c.cstr(), "a/r"), 0, "ensure_cstr contents");
+        })
+        .tests("typed string views", []() {
+            toolbox::ram_strref a{"  Hello World!"};
+            toolbox::progmem_strref b{PSTR("Hello World!")};
+            expect::equals(a.length(), 14u, "ram length");
+            expect::equals(b.length(), 12u, "progmem length");
+            expect::equals(a.charAt(2), 'H', "ram charAt");
+            expect::equals(b.charAt(1), 'e', "progmem charAt");
+            expect::equals(a.indexOf('W'), 8, "ram indexOf");
+            expect::equals(b.indexOf('x'), -1, "progmem indexOf missing");
+            expect::isTrue(a.ltrim(' ') == b, "ltrim and compare ram to progmem");
+            expect::isTrue(b == a.ltrim(' '), "compare progmem to ram");
+            expect::isTrue(b.startsWith(toolbox::ram_strref{"Hello"}), "startsWith");
+            expect::isTrue(b.endsWith(toolbox::progmem_strref{PSTR("World!")}), "endsWith");
+            expect::isTrue(b.skip(1).isZeroTerminated(), "skip keeps zero termination");
+            expect::isFalse(b.leftmost(5).isZeroTerminated(), "leftmost is partial");
+
+            toolbox::strref c = b.leftmost(5);
+            expect::isTrue(c.isInProgmem(), "progmem view converts to progmem strref");
+            expect::equals(c, "Hello", "converted contents");
+            toolbox::strref d = a.skip(2);
+            expect::isFalse(d.isInProgmem(), "ram view converts to ram strref");
+            expect::equals(d, "Hello World!", "converted ram contents");
+
+            expect::equals(c.visit([] (auto view) { return view.indexOf('l'); }), 2, "visit progmem");
+            expect::equals(d.ltrim('H'), "ello World!", "strref ltrim via visit");
+            char buffer[6];
+            expect::equals(b.copy(buffer, sizeof(buffer), true), 5u, "copy length");
+            expect::equals(strcmp(buffer, "Hello"), 0, "copy contents");
+        })
+        .tests("progmem block access", []() {
+            toolbox::strref a{FPSTR(PSTR("config/network/wifi/ssid;config/network/wifi/password"))};
+            toolbox::strref b{FPSTR(PSTR("config/network/wifi/ssid;config/network/wifi/passworD"))};
+            toolbox::strref c{"config/network/wifi/ssid;config/network/wifi/password"};
+            expect::isTrue(a > b, "progmem difference in last block");
+            expect::isTrue(b < a, "progmem difference in last block reversed");
+            expect::isTrue(a == c, "progmem equals ram");
+            expect::isTrue(c > b, "ram compared to progmem");
+            expect::isTrue(b < c, "progmem compared to ram");
+            expect::equals(a.indexOf('p'), 45, "progmem indexOf beyond first block");
+            expect::equals(a.indexOf('x'), -1, "progmem indexOf missing");
+            expect::isTrue(a.endsWith(FPSTR(PSTR("password"))), "progmem endsWith");
+            expect::isTrue(a.startsWith("config/"), "progmem startsWith");
+        })
+        .tests("substring and character search", []() {
+            toolbox::strref a{"GET /index.html HTTP/1.1\r\nHost: example.com\r\n\r\npayload"};
+            toolbox::strref b{FPSTR(PSTR("GET /index.html HTTP/1.1\r\nHost: example.com\r\n\r\npayload"))};
+            String c{"GET /index.html HTTP/1.1\r\nHost: example.com\r\n\r\npayload"};
+            toolbox::strref views[] {a, b, toolbox::strref{c}, toolbox::strref{a.materialize()}};
+            for (const auto& view : views) {
+                expect::equals(view.find("\r\n\r\n"), 43, "find header end");
+                expect::equals(view.find(FPSTR(PSTR("\r\n"))), 24, "find progmem needle");
+                expect::equals(view.find("\r\n", 26), 43, "find from");
+                expect::equals(view.find("HTTP/2"), -1, "find missing");
+                expect::equals(view.find(""), 0, "find empty needle");
+                expect::equals(view.find("payload!"), -1, "find needle exceeding end");
+                expect::equals(view.rfind("\r\n"), 45, "rfind");
+                expect::equals(view.rfind("GET"), 0, "rfind at start");
+                expect::equals(view.rfind("POST"), -1, "rfind missing");
+                expect::equals(view.findFirstOf(" :"), 3, "findFirstOf");
+                expect::equals(view.findFirstOf(":\r", 30), 30, "findFirstOf from");
+                expect::equals(view.findFirstOf("#%!"), -1, "findFirstOf missing");
+                expect::equals(view.indexOf('e'), 8, "indexOf");
+                expect::equals(view.indexOf('e', 9), 32, "indexOf from");
+                expect::equals(view.indexOf('d', 60), -1, "indexOf from beyond end");
+                expect::equals(view.skip(4).find("HTTP"), 12, "find in slice");
+                expect::equals(view.leftmost(18).indexOf('P'), -1, "indexOf respects length");
+                expect::equals(view.leftmost(29).find("Host"), -1, "find respects length");
+            }
+
+            toolbox::strref longNeedle{"ab-cdefghijklmnopqrstuvwxyz0123456789"};
+            toolbox::strref haystack{"zz ab-cdefghijklmnopqrstuvwxyz012345678 ab-cdefghijklmnopqrstuvwxyz0123456789 zz"};
+            expect::equals(haystack.find(longNeedle), 40, "find long needle");
+            expect::equals(haystack.rfind(longNeedle), 40, "rfind long needle");
+        })
+        .tests("compile-time string literals", []() {
+            using namespace toolbox::literals;
+            constexpr toolbox::ram_strref a = "config/key"_sr;
+            static_assert(a.length() == 10u, "literal length is known at compile time");
+            toolbox::strref b = a;
+            expect::isFalse(b.isInProgmem(), "ram literal");
+            expect::isTrue(b.isZeroTerminated(), "ram literal zero terminated");
+            expect::equals(b, "config/key", "ram literal contents");
+            expect::equals(toolbox::strref{"with\0null"_sr}.length(), 9u, "ram literal with embedded null");
+
+            toolbox::strref c = TOOLBOX_FSTR("progmem/key");
+            expect::isTrue(c.isInProgmem(), "progmem literal");
+            expect::isTrue(c.isZeroTerminated(), "progmem literal zero terminated");
+            expect::equals(c.length(), 11u, "progmem literal length");
+            expect::equals(c, "progmem/key", "progmem literal contents");
+            expect::isTrue(toolbox::strref{TOOLBOX_FSTR("")}.empty(), "empty progmem literal");
+        })
+        .tests("lazy split", []() {
+            toolbox::AllocatorScope scope{countingAllocator};
+            const char* expected[] = {"home", "kitchen", "", "temperature"};
+            toolbox::strref a{"home/kitchen//temperature"};
+            toolbox::strref b{FPSTR(PSTR("home/kitchen//temperature"))};
+            for (const auto& path : {a, b}) {
+                size_t i = 0;
+                for (const auto& segment : path.split('/')) {
+                    expect::isTrue(i < 4, "segment count");
+                    expect::equals(segment, expected[i], "segment");
+                    ++i;
+                }
+                expect::equals(i, 4u, "all segments");
+            }
+
+            size_t count = 0;
+            toolbox::strref shared = toolbox::strref{"a=1\r\nb=2\r\nc=3"}.materialize();
+            const size_t allocationsBefore = countingAllocator.allocations;
+            for (const auto& line : shared.split("\r\n")) {
+                expect::equals(line.length(), 3u, "line length");
+                expect::equals(line.charAt(1), '=', "line contents");
+                ++count;
+            }
+            expect::equals(count, 3u, "lines");
+            expect::equals(countingAllocator.allocations, allocationsBefore, "split does not allocate");
+
+            count = 0;
+            for (const auto& token : toolbox::strref{"12, 345;-7"}.splitAny(", ;")) {
+                (void)token;
+                ++count;
+            }
+            expect::equals(count, 4u, "splitAny tokens");
+
+            auto tokens = toolbox::strref{"x,"}.split(',');
+            auto it = tokens.begin();
+            expect::equals(*it, "x", "first token");
+            expect::equals(*++it, "", "trailing empty token");
+            expect::isTrue(++it == tokens.end(), "end after trailing token");
+
+            count = 0;
+            for (const auto& token : toolbox::strref{}.split(',')) {
+                expect::isTrue(token.empty(), "empty string yields one empty token");
+                ++count;
+            }
+            expect::equals(count, 1u, "empty string tokens");
+
+            count = 0;
+            for (const auto& token : toolbox::strref{"abc"}.split("")) {
+                expect::equals(token, "abc", "empty delimiter does not split");
+                ++count;
+            }
+            expect::equals(count, 1u, "empty delimiter tokens");
+
+            String string{"a:b:c:d"};
+            toolbox::strref bounded{string, 3};
+            count = 0;
+            for (const auto& token : bounded.split(':')) {
+                (void)token;
+                ++count;
+            }
+            expect::equals(count, 2u, "split respects view length");
+        })
+        .tests("case-insensitive operations", []() {
+            toolbox::AllocatorScope scope{countingAllocator};
+            String string{"Content-Type: TEXT/plain"};
+            toolbox::strref header{string};
+            toolbox::strref progmem = TOOLBOX_FSTR("content-type: text/PLAIN");
+            toolbox::shared_str shared{"CONTENT-TYPE"};
+
+            size_t allocationsBefore = countingAllocator.allocations;
+            expect::isTrue(header.equalsIgnoreCase(progmem), "ram equals progmem");
+            expect::isTrue(progmem.equalsIgnoreCase(header), "progmem equals ram");
+            expect::isTrue(header.leftmost(12).equalsIgnoreCase(shared), "equals shared");
+            expect::isFalse(header.equalsIgnoreCase("content-type"), "different length");
+            expect::equals(header.compareIgnoreCase(progmem), 0, "compare equal");
+            expect::isTrue(toolbox::strref{"apple"}.compareIgnoreCase("BANANA") < 0, "compare less");
+            expect::isTrue(toolbox::strref{"Zebra"}.compareIgnoreCase("zeal!") > 0, "compare greater");
+            expect::isTrue(toolbox::strref{"[Z]"}.compareIgnoreCase("[a]") > 0, "compare letters after folding");
+            expect::isFalse(toolbox::strref{"@"}.equalsIgnoreCase("`"), "non-letters are not folded");
+
+            expect::equals(header.findIgnoreCase("text/"), 14, "find in ram");
+            expect::equals(progmem.findIgnoreCase("TEXT/"), 14, "find in progmem");
+            expect::equals(header.findIgnoreCase(TOOLBOX_FSTR("plain")), 19, "find progmem needle");
+            expect::equals(header.findIgnoreCase("type", 9), -1, "find from position");
+            expect::equals(header.findIgnoreCase("xml"), -1, "find missing");
+            expect::equals(header.findIgnoreCase(""), 0, "find empty");
+            expect::equals(countingAllocator.allocations, allocationsBefore, "case-insensitive operations do not allocate");
+
+            char buffer[32];
+            expect::equals(progmem.toUpper(buffer, sizeof(buffer), true), 24u, "toUpper length");
+            expect::equals(toolbox::strref{buffer}, "CONTENT-TYPE: TEXT/PLAIN", "toUpper");
+            expect::equals(header.toLower(buffer, sizeof(buffer), true), 24u, "toLower length");
+            expect::equals(toolbox::strref{buffer}, "content-type: text/plain", "toLower");
+            expect::equals(header.toLower(buffer, 8, true), 7u, "toLower truncated");
+            expect::equals(toolbox::strref{buffer}, "content", "toLower truncated content");
+        })
+        .tests("utf-8", []() {
+            toolbox::AllocatorScope scope{countingAllocator};
+            toolbox::strref ascii{"plain ASCII text, long enough for whole words"};
+            toolbox::strref mixed{"Gr\xC3\xBC\xC3\x9F" "e \xE2\x82\xAC 5 \xF0\x9F\x98\x80"};
+            toolbox::strref progmem = TOOLBOX_FSTR("\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC");
+
+            size_t allocationsBefore = countingAllocator.allocations;
+            expect::isTrue(ascii.isValidUtf8(), "ascii valid");
+            expect::equals(ascii.countCodePoints(), ascii.length(), "ascii code points");
+            expect::isTrue(mixed.isValidUtf8(), "mixed valid");
+            expect::equals(mixed.countCodePoints(), 11u, "mixed code points");
+            expect::isTrue(progmem.isValidUtf8(), "progmem valid across blocks");
+            expect::equals(progmem.countCodePoints(), 12u, "progmem code points");
+            expect::isTrue(toolbox::strref{}.isValidUtf8(), "empty valid");
+
+            expect::isTrue(mixed.leftmost(3).isPartial(), "partial view");
+            expect::isFalse(mixed.leftmost(3).isValidUtf8(), "truncated sequence in partial view");
+            expect::isFalse(progmem.leftmost(35).isValidUtf8(), "truncated sequence in progmem view");
+            expect::isTrue(progmem.skip(3).leftmost(33).isValidUtf8(), "progmem view at sequence boundaries");
+            expect::isFalse(toolbox::strref{"\xC0\xAF"}.isValidUtf8(), "overlong");
+            expect::isFalse(toolbox::strref{"\xED\xA0\x80"}.isValidUtf8(), "surrogate");
+            expect::isFalse(toolbox::strref{"\xF4\x90\x80\x80"}.isValidUtf8(), "above U+10FFFF");
+            expect::isFalse(toolbox::strref{"abc\x80"}.isValidUtf8(), "lone continuation byte");
+            expect::equals(countingAllocator.allocations, allocationsBefore, "utf-8 functions do not allocate");
+
+            const uint32_t expected[] = {'G', 'r', 0xFCu, 0xDFu, 'e', ' ', 0x20ACu, ' ', '5', ' ', 0x1F600u};
+            size_t count = 0;
+            for (uint32_t codePoint : mixed.codePoints()) {
+                expect::equals(codePoint, count < 11 ? expected[count] : 0u, "decoded code point");
+                ++count;
+            }
+            expect::equals(count, 11u, "decoded code points");
+
+            count = 0;
+            for (uint32_t codePoint : progmem.skip(1).leftmost(5).codePoints()) {
+                expect::equals(codePoint, count < 2 ? toolbox::REPLACEMENT_CODE_POINT : 0x20ACu, "decoded with replacement");
+                ++count;
+            }
+            expect::equals(count, 3u, "invalid bytes are replaced one at a time");
         });
-}
+}
\ No newline at end of file
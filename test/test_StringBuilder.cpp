@@ -0,0 +1,54 @@
+#include <yatest.h>
+#include <toolbox/StringBuilder.h>
+
+using namespace yatest;
+
+namespace {
+static const TestSuite& TestStringBuilder =
+    suite("StringBuilder")
+        .tests("append and materialize", []() {
+            toolbox::StringBuilder builder{toolbox::defaultAllocator(), 8};
+            builder.append("{\"temperature\":").append(-12).append(',').append(FPSTR(PSTR("\"valid\":"))).append(true).append('}');
+            expect::equals(builder.length(), 32u, "length");
+            expect::isFalse(builder.isTruncated(), "not truncated");
+
+            toolbox::shared_str result = builder.materialize();
+            expect::equals(strcmp(result.cstr(), "{\"temperature\":-12,\"valid\":true}"), 0, "contents");
+
+            char buffer[64] = "";
+            toolbox::StringOutput output{buffer};
+            expect::equals(builder.writeTo(output), 32u, "written length");
+            expect::equals(strcmp(buffer, result.cstr()), 0, "written contents");
+
+            builder.clear();
+            expect::isTrue(builder.empty(), "empty after clear");
+            expect::isTrue(builder.materialize().empty(), "materialize empty builder");
+        })
+        .tests("caller-provided buffer", []() {
+            alignas(toolbox::ALLOCATION_ALIGNMENT) char buffer[128];
+            toolbox::StringBuilder builder{buffer, 16};
+            for (int i = 0; i < 100; ++i) {
+                builder.append(i);
+            }
+            expect::isTrue(builder.isTruncated(), "truncated when buffer is exhausted");
+            expect::isTrue(builder.length() > 0u, "kept contents");
+            expect::isTrue(toolbox::strref{builder.materialize()}.startsWith("0123456789101112"), "kept beginning");
+        })
+        .tests("spill to output", []() {
+            alignas(toolbox::ALLOCATION_ALIGNMENT) char buffer[128];
+            char result[512] = "";
+            toolbox::StringOutput output{result};
+            toolbox::StringBuilder builder{buffer, 16};
+            builder.spillTo(output);
+            for (int i = 0; i < 100; ++i) {
+                builder.append(i).append(',');
+            }
+            expect::isFalse(builder.isTruncated(), "not truncated");
+            expect::isTrue(builder.spilledLength() > 0u, "spilled");
+            expect::equals(builder.spilledLength() + builder.length(), 290u, "total length");
+            builder.flush();
+            expect::equals(strlen(result), 290u, "all contents written");
+            expect::isTrue(toolbox::strref{result}.startsWith("0,1,2,3,"), "beginning");
+            expect::isTrue(toolbox::strref{result}.endsWith("97,98,99,"), "end");
+        });
+}
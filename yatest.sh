@@ -30,3 +30,9 @@ if [ ! -f "$YATEST_DIR/src/build-and-run.sh" ]; then
 fi
 
 "$YATEST_DIR/src/build-and-run.sh" "$LIB_DIR"
+
+# Once more with the atomic shared_str reference counter. This builds and runs
+# test_AtomicRefCount.cpp, which is empty otherwise, and reports the reference
+# counting benchmarks for the atomic counter next to the plain ones above.
+echo "Building and running tests with TOOLBOX_ATOMIC_REFCOUNT..."
+CXXFLAGS="$CXXFLAGS -DTOOLBOX_ATOMIC_REFCOUNT" "$YATEST_DIR/src/build-and-run.sh" "$LIB_DIR"